@@ -0,0 +1,437 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QThreadPool>
+#include <QTimer>
+#include <QtConcurrent>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <functional>
+#include <limits>
+#include <memory>
+
+#include "core/dbc/dbc_manager.h"
+#include "core/streams/asc_log_stream.h"
+#include "core/streams/blf_log_stream.h"
+#include "core/streams/candump_log_stream.h"
+#include "core/streams/capture_stream.h"
+#include "core/streams/device_stream.h"
+#include "core/streams/mf4_log_stream.h"
+#include "core/streams/panda_stream.h"
+#include "core/streams/pcap_log_stream.h"
+#include "core/streams/socket_can_stream.h"
+#include "core/streams/synthetic_stream.h"
+#include "core/streams/trc_log_stream.h"
+#include "modules/settings/settings.h"
+
+// Headless front end for batch jobs on machines without a display. It loads a stream and
+// an optional DBC, runs one command over all messages in parallel and writes CSV.
+
+namespace {
+
+struct Filter {
+  QSet<int> buses;
+  QSet<uint32_t> addresses;
+
+  bool accepts(const MessageId& id) const {
+    return (buses.isEmpty() || buses.contains(id.source)) && (addresses.isEmpty() || addresses.contains(id.address));
+  }
+};
+
+struct Condition {
+  std::function<bool(double)> cmp;
+  QString text;
+};
+
+AbstractStream* createFileStream(const QStringList& files, QObject* parent) {
+  const QString ext = QFileInfo(files.first()).suffix().toLower();
+  for (const QString& f : files) {
+    if (QFileInfo(f).suffix().toLower() != ext) {
+      qCritical() << "All input files must be of the same type";
+      return nullptr;
+    }
+  }
+
+  if (ext == "asc") return new AscLogStream(parent, files);
+  if (ext == "blf") return new BlfLogStream(parent, files);
+  if (ext == "log") return new CandumpLogStream(parent, files);
+  if (ext == "trc") return new TrcLogStream(parent, files);
+  if (ext == "mf4") return new Mf4LogStream(parent, files);
+  if (ext == "pcap" || ext == "pcapng" || ext == "cap") return new PcapLogStream(parent, files);
+  if (ext == "ccap") {
+    // Captures are decoded on demand, the commands below read all of it
+    auto* stream = new CaptureStream(parent, files);
+    stream->decodeAll();
+    return stream;
+  }
+  qCritical() << "Unsupported file type" << ext;
+  return nullptr;
+}
+
+// Live sources are recorded for --duration seconds before the command runs
+AbstractStream* createLiveStream(QCommandLineParser& p, QCoreApplication* app) {
+  // Nothing is written to disk unless asked for, whatever the GUI is set to log
+  settings.log_livestream = p.isSet("log");
+  if (settings.log_livestream) {
+    settings.log_path = p.value("log");
+    settings.log_compress = false;
+    settings.log_capture = true;
+  }
+
+  LiveStream* stream = nullptr;
+  try {
+    if (p.isSet("msgq") || p.isSet("zmq")) {
+      stream = new DeviceStream(app, p.value("zmq"));
+    } else if (p.isSet("panda") || p.isSet("panda-serial")) {
+      stream = new PandaStream(app, {p.value("panda-serial")});
+    } else if (p.isSet("synthetic")) {
+      stream = new SyntheticStream(app, {.dbc_file = p.value("dbc"),
+                                         .rate = p.value("synthetic").toInt(),
+                                         .buses = p.value("synthetic-buses").toInt()});
+    } else if (SocketCanStream::available() && p.isSet("socketcan")) {
+      stream = new SocketCanStream(app, {p.value("socketcan").split(',', Qt::SkipEmptyParts)});
+    }
+  } catch (const std::exception& e) {
+    qCritical() << e.what();
+    return nullptr;
+  }
+  if (!stream) return nullptr;
+
+  const double duration = p.value("duration").toDouble();
+  qInfo() << "Recording" << stream->routeName() << "for" << duration << "seconds";
+  stream->start();
+  QTimer::singleShot(duration * 1000, app, &QCoreApplication::quit);
+  app->exec();
+  stream->stop();
+  return stream;
+}
+
+std::vector<MessageId> messageIds(const AbstractStream* stream, const Filter& filter) {
+  std::vector<MessageId> ids;
+  for (const auto& [id, events] : stream->eventsMap()) {
+    if (!events.empty() && filter.accepts(id)) ids.push_back(id);
+  }
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+QString hexData(const CanEvent* e) {
+  return QByteArray::fromRawData((const char*)e->dat, e->size).toHex().toUpper();
+}
+
+// Per-message timing and activity
+QStringList stats(const AbstractStream* stream, const std::vector<MessageId>& ids) {
+  QStringList rows = QtConcurrent::blockingMapped<QStringList>(ids, [stream](const MessageId& id) {
+    const auto& events = stream->events(id);
+    const uint64_t count = events.size();
+    uint64_t min_gap = std::numeric_limits<uint64_t>::max(), max_gap = 0;
+    std::vector<uint8_t> changed(events.front()->size, 0);
+    for (size_t i = 1; i < events.size(); ++i) {
+      const uint64_t gap = events[i]->mono_ns - events[i - 1]->mono_ns;
+      min_gap = std::min(min_gap, gap);
+      max_gap = std::max(max_gap, gap);
+      const size_t n = std::min<size_t>({changed.size(), events[i]->size, events[i - 1]->size});
+      for (size_t j = 0; j < n; ++j) changed[j] |= events[i]->dat[j] ^ events[i - 1]->dat[j];
+    }
+
+    int changing_bits = 0;
+    for (uint8_t bits : changed) changing_bits += __builtin_popcount(bits);
+    const double first = stream->toSeconds(events.front()->mono_ns);
+    const double last = stream->toSeconds(events.back()->mono_ns);
+    const double freq = last > first ? (count - 1) / (last - first) : 0;
+    return QString("%1,0x%2,%3,%4,%5,%6,%7,%8,%9,%10,%11")
+        .arg(id.source)
+        .arg(id.address, 0, 16)
+        .arg(msgName(id))
+        .arg(events.front()->size)
+        .arg(count)
+        .arg(first, 0, 'f', 3)
+        .arg(last, 0, 'f', 3)
+        .arg(freq, 0, 'f', 2)
+        .arg(count > 1 ? min_gap / 1e6 : 0, 0, 'f', 3)
+        .arg(max_gap / 1e6, 0, 'f', 3)
+        .arg(changing_bits);
+  });
+  rows.prepend("bus,addr,name,size,count,first_sec,last_sec,freq_hz,min_gap_ms,max_gap_ms,changing_bits");
+  return rows;
+}
+
+QString exportMessage(const AbstractStream* stream, const MessageId& id, bool decode) {
+  QString csv;
+  QTextStream out(&csv);
+  auto msg = GetDBC()->msg(id);
+  if (decode && msg && !msg->sigs.empty()) {
+    out << "time,addr,bus";
+    for (auto s : msg->sigs) out << "," << s->name;
+    out << "\n";
+    for (auto e : stream->events(id)) {
+      out << QString::number(stream->toSeconds(e->mono_ns), 'f', 3) << ",0x" << QString::number(e->address, 16)
+          << "," << e->src;
+      for (auto s : msg->sigs) {
+        out << "," << QString::number(s->parse(e->dat, e->size).value_or(0), 'f', s->precision);
+      }
+      out << "\n";
+    }
+  } else {
+    out << "time,addr,bus,data\n";
+    for (auto e : stream->events(id)) {
+      out << QString::number(stream->toSeconds(e->mono_ns), 'f', 3) << ",0x" << QString::number(e->address, 16)
+          << "," << e->src << ",0x" << hexData(e) << "\n";
+    }
+  }
+  out.flush();
+  return csv;
+}
+
+// With an output directory every message gets its own file; otherwise all frames go to one stream
+bool exportCsv(const AbstractStream* stream, const std::vector<MessageId>& ids, bool decode, const QString& output,
+               QTextStream& out) {
+  if (!output.isEmpty() && QFileInfo(output).isDir()) {
+    std::atomic<int> failures = 0;
+    QtConcurrent::blockingMap(ids, [&](const MessageId& id) {
+      QString name = QString("%1_%2_%3.csv").arg(msgName(id)).arg(id.source).arg(id.address, 0, 16);
+      QFile file(QDir(output).filePath(name));
+      if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Failed to write" << file.fileName();
+        ++failures;
+        return;
+      }
+      file.write(exportMessage(stream, id, decode).toUtf8());
+    });
+    return failures == 0;
+  }
+
+  if (decode) {
+    // Long format, so messages with different signals fit in one table
+    QStringList chunks = QtConcurrent::blockingMapped<QStringList>(ids, [stream](const MessageId& id) {
+      QString csv;
+      QTextStream s(&csv);
+      auto msg = GetDBC()->msg(id);
+      if (!msg) return csv;
+      for (auto e : stream->events(id)) {
+        const QString prefix = QString("%1,0x%2,%3,%4,")
+                                   .arg(stream->toSeconds(e->mono_ns), 0, 'f', 3)
+                                   .arg(e->address, 0, 16)
+                                   .arg(e->src)
+                                   .arg(msg->name);
+        for (auto sig : msg->sigs) {
+          if (auto v = sig->parse(e->dat, e->size)) {
+            s << prefix << sig->name << "," << QString::number(*v, 'f', sig->precision) << "\n";
+          }
+        }
+      }
+      s.flush();
+      return csv;
+    });
+    out << "time,addr,bus,message,signal,value\n";
+    for (const QString& c : chunks) out << c;
+  } else {
+    out << "time,addr,bus,data\n";
+    for (auto e : stream->allEvents()) {
+      if (std::binary_search(ids.begin(), ids.end(), MessageId(e->src, e->address))) {
+        out << QString::number(stream->toSeconds(e->mono_ns), 'f', 3) << ",0x" << QString::number(e->address, 16)
+            << "," << e->src << ",0x" << hexData(e) << "\n";
+      }
+    }
+  }
+  return true;
+}
+
+std::optional<Condition> parseCondition(const QString& text) {
+  const QStringList parts = text.split(':');
+  bool ok1 = false, ok2 = true;
+  const double v1 = parts.value(1).toDouble(&ok1);
+  const double v2 = parts.size() > 2 ? parts[2].toDouble(&ok2) : 0;
+  if (!ok1 || !ok2) return std::nullopt;
+
+  const QString op = parts[0];
+  std::function<bool(double)> cmp;
+  if (op == "=") cmp = [v1](double v) { return v == v1; };
+  else if (op == ">") cmp = [v1](double v) { return v > v1; };
+  else if (op == ">=") cmp = [v1](double v) { return v >= v1; };
+  else if (op == "!=") cmp = [v1](double v) { return v != v1; };
+  else if (op == "<") cmp = [v1](double v) { return v < v1; };
+  else if (op == "<=") cmp = [v1](double v) { return v <= v1; };
+  else if (op == "between" && parts.size() > 2) cmp = [v1, v2](double v) { return v >= v1 && v <= v2; };
+  else return std::nullopt;
+  return Condition{cmp, text};
+}
+
+// Same search as the Find Signal dialog: every bit range of every message is a candidate, and each
+// condition keeps the candidates whose value matches it after the previous condition's match.
+QStringList findSignal(const AbstractStream* stream, const std::vector<MessageId>& ids, const dbc::Signal& proto,
+                       int min_size, int max_size, const std::vector<Condition>& conditions) {
+  struct Candidate {
+    MessageId id;
+    dbc::Signal sig;
+    uint64_t mono_ns = 0;
+    bool matched = false;
+    QStringList values;
+  };
+
+  std::vector<Candidate> candidates;
+  for (const auto& id : ids) {
+    const int total_size = stream->events(id).front()->size * 8;
+    for (int size = min_size; size <= max_size; ++size) {
+      for (int start = 0; start <= total_size - size; ++start) {
+        Candidate c{.id = id, .sig = proto};
+        c.sig.start_bit = start;
+        c.sig.size = size;
+        c.sig.update();
+        candidates.push_back(std::move(c));
+      }
+    }
+  }
+
+  for (const auto& cond : conditions) {
+    QtConcurrent::blockingMap(candidates, [&](Candidate& c) {
+      const auto& events = stream->events(c.id);
+      auto first = c.mono_ns == 0 ? events.cbegin()
+                                  : std::ranges::upper_bound(events, c.mono_ns, {}, &CanEvent::mono_ns);
+      auto it = std::find_if(first, events.cend(), [&](auto e) { return cond.cmp(c.sig.toPhysical(e->dat, e->size)); });
+      c.matched = it != events.cend();
+      if (c.matched) {
+        c.mono_ns = (*it)->mono_ns;
+        c.values += QString("(%1, %2)")
+                        .arg(stream->toSeconds(c.mono_ns), 0, 'f', 3)
+                        .arg(c.sig.toPhysical((*it)->dat, (*it)->size));
+      }
+    });
+    std::erase_if(candidates, [](const Candidate& c) { return !c.matched; });
+  }
+
+  QStringList rows = {"id,start_bit,size,matches"};
+  for (const auto& c : candidates) {
+    rows += QString("%1,%2,%3,%4").arg(c.id.toString()).arg(c.sig.start_bit).arg(c.sig.size).arg(c.values.join(" "));
+  }
+  return rows;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  QCoreApplication app(argc, argv);
+  QCoreApplication::setApplicationName("cabana-cli");
+  settings.save_on_exit = false;
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription(
+      "Headless Cabana.\n\n"
+      "Commands:\n"
+      "  stats        per-message count, timing and changing bits\n"
+      "  export       frames as CSV, decoded into signals when a DBC is given\n"
+      "  find-signal  bit ranges whose value passes every --find condition in turn");
+  parser.addHelpOption();
+  parser.addPositionalArgument("command", "stats, export or find-signal");
+  parser.addPositionalArgument("files", "log files to load (.asc .blf .log .trc .mf4 .pcap .pcapng .ccap)",
+                               "[files...]");
+  parser.addOptions({
+      {{"dbc", "b"}, "dbc file to decode with", "dbc"},
+      {{"output", "o"}, "output file, or directory for one CSV per message (export). Default: stdout", "path"},
+      {{"threads", "j"}, "worker threads. Default: all cores", "n"},
+      {"bus", "only these buses, comma separated", "buses"},
+      {"address", "only these addresses, comma separated hex", "addresses"},
+      {"raw", "export raw frames even when a DBC is given"},
+      {"find", "find-signal condition OP:VALUE[:VALUE2], OP is = > >= != < <= or between. Repeatable", "cond"},
+      {"min-size", "find-signal minimum size in bits. Default: 8", "bits", "8"},
+      {"max-size", "find-signal maximum size in bits. Default: 8", "bits", "8"},
+      {"big-endian", "find-signal candidates are big endian"},
+      {"signed", "find-signal candidates are signed"},
+      {"factor", "find-signal factor. Default: 1", "factor", "1"},
+      {"offset", "find-signal offset. Default: 0", "offset", "0"},
+      {"msgq", "record from the msgq"},
+      {{"zmq", "z"}, "record from zmq at the specified ip-address", "ip-address"},
+      {"panda", "record from panda"},
+      {{"panda-serial", "s"}, "record from panda with given serial", "panda-serial"},
+      {"socketcan", "record from SocketCAN device(s), comma separated", "socketcan"},
+      {"synthetic", "record generated traffic at the given frames per second, from --dbc if given", "rate"},
+      {"synthetic-buses", "number of buses to generate on. Default: 1", "buses", "1"},
+      {"duration", "seconds to record from a live source. Default: 10", "seconds", "10"},
+      {"log", "also save what is recorded from a live source as rlogs and a Cabana capture", "dir"},
+  });
+  parser.process(app);
+
+  QStringList args = parser.positionalArguments();
+  const QString command = args.value(0);
+  if (command != "stats" && command != "export" && command != "find-signal") {
+    parser.showHelp(1);
+  }
+  if (parser.isSet("threads")) {
+    QThreadPool::globalInstance()->setMaxThreadCount(std::max(1, parser.value("threads").toInt()));
+  }
+
+  if (parser.isSet("dbc")) {
+    QString error;
+    if (!GetDBC()->open(SOURCE_ALL, parser.value("dbc"), &error)) {
+      qCritical() << "Failed to open DBC:" << error;
+      return 1;
+    }
+  }
+
+  std::unique_ptr<AbstractStream> stream;
+  if (args.size() > 1) {
+    stream.reset(createFileStream(args.mid(1), &app));
+  } else {
+    stream.reset(createLiveStream(parser, &app));
+  }
+  if (!stream || stream->allEvents().empty()) {
+    qCritical() << "No CAN frames loaded";
+    return 1;
+  }
+
+  Filter filter;
+  for (const auto& b : parser.value("bus").split(',', Qt::SkipEmptyParts)) filter.buses.insert(b.toInt());
+  for (const auto& a : parser.value("address").split(',', Qt::SkipEmptyParts)) {
+    filter.addresses.insert(a.toUInt(nullptr, 16));
+  }
+  const std::vector<MessageId> ids = messageIds(stream.get(), filter);
+
+  QFile out_file;
+  const QString output = parser.value("output");
+  const bool to_dir = command == "export" && !output.isEmpty() && QFileInfo(output).isDir();
+  if (output.isEmpty() || to_dir) {
+    out_file.open(stdout, QIODevice::WriteOnly);
+  } else {
+    out_file.setFileName(output);
+    if (!out_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+      qCritical() << "Failed to open" << output;
+      return 1;
+    }
+  }
+  QTextStream out(&out_file);
+
+  bool ok = true;
+  if (command == "stats") {
+    out << stats(stream.get(), ids).join("\n") << "\n";
+  } else if (command == "export") {
+    ok = exportCsv(stream.get(), ids, parser.isSet("dbc") && !parser.isSet("raw"), to_dir ? output : QString(), out);
+  } else {
+    std::vector<Condition> conditions;
+    for (const QString& text : parser.values("find")) {
+      auto cond = parseCondition(text);
+      if (!cond) {
+        qCritical() << "Invalid condition" << text;
+        return 1;
+      }
+      conditions.push_back(*cond);
+    }
+    if (conditions.empty()) {
+      qCritical() << "find-signal needs at least one --find condition";
+      return 1;
+    }
+
+    dbc::Signal sig{};
+    sig.is_little_endian = !parser.isSet("big-endian");
+    sig.is_signed = parser.isSet("signed");
+    sig.factor = parser.value("factor").toDouble();
+    sig.offset = parser.value("offset").toDouble();
+    const int min_size = std::clamp(parser.value("min-size").toInt(), 1, 64);
+    const int max_size = std::clamp(parser.value("max-size").toInt(), min_size, 64);
+    out << findSignal(stream.get(), ids, sig, min_size, max_size, conditions).join("\n") << "\n";
+  }
+  return ok ? 0 : 1;
+}
@@ -8,6 +8,8 @@
 
 #include "common/timing.h"
 #include "modules/settings/settings.h"
+#include "utils/perf.h"
+#include "utils/trace.h"
 
 static constexpr int EVENT_BUFFER_CHUNK_SIZE = 6 * 1024 * 1024;  // 6MB
 
@@ -30,6 +32,8 @@ AbstractStream::AbstractStream(QObject* parent) : QObject(parent) {
 }
 
 void AbstractStream::commitSnapshots() {
+  TRACE_SCOPE("commitSnapshots");
+  perf::ScopedTimer perf_timer(perf::Timing::SnapshotCommit);
   std::set<MessageId> updated_ids;
   bool structure_changed = false;
   const size_t prev_source_count = sources_.size();
@@ -45,6 +49,7 @@ void AbstractStream::commitSnapshots() {
       state.dirty = false;
     }
     updated_ids = std::move(shared_state_.dirty_ids);
+    updateTableUsage();
   }
 
   // Compute colors outside lock — purely presentational, main-thread-only
@@ -75,23 +80,158 @@ void AbstractStream::setTimeRange(const std::optional<std::pair<double, double>>
   emit timeRangeChanged(time_range_);
 }
 
-void AbstractStream::processNewMessage(const MessageId& id, uint64_t mono_ns, const uint8_t* data, uint8_t size) {
+void AbstractStream::processNewMessages(CanEventIter first, CanEventIter last, bool coalesce) {
+  if (first == last) return;
+  TRACE_SCOPE("processNewMessages");
+
   std::lock_guard lk(mutex_);
-  const double sec = toSeconds(mono_ns);
-  shared_state_.current_sec = sec;
+  // Only each message's last frame of the run can be displayed. Find them walking backwards.
+  if (coalesce) {
+    coalesce_last_.clear();
+    for (auto it = last; it != first;) {
+      const CanEvent* e = *--it;
+      coalesce_last_.try_emplace(MessageId(e->src, e->address), e);
+    }
+  }
 
-  auto& state = shared_state_.master_state[id];
-  if (state.size != size) {
-    state.init(data, size, sec);
-    state.setDbcMask(getMask(id));
+  shared_state_.cursor_ns = (*std::prev(last))->mono_ns;
+  shared_state_.current_sec = toSeconds(shared_state_.cursor_ns);
+  for (auto it = first; it != last; ++it) {
+    const CanEvent* e = *it;
+    const MessageId id(e->src, e->address);
+    const double sec = toSeconds(e->mono_ns);
+    auto& state = shared_state_.master_state[id];
+    if (state.size != e->size) {
+      state.init(e->dat, e->size, sec);
+      state.setDbcMask(getMask(id));
+    } else if (coalesce && coalesce_last_[id] != e) {
+      state.skip(e->dat, e->size, sec);
+    } else {
+      state.update(e->dat, e->size, sec);
+    }
+
+    if (!state.dirty) {
+      state.dirty = true;
+      shared_state_.dirty_ids.insert(id);
+    }
+  }
+}
+
+bool AbstractStream::stepFrame(int direction, std::optional<MessageId> id) {
+  if (!isPaused()) pause(true);
+  playReverse(false);
+
+  uint64_t cursor_ns;
+  {
+    std::lock_guard lk(mutex_);
+    cursor_ns = shared_state_.cursor_ns;
+  }
+
+  // Events sharing a timestamp are one frame
+  const auto& list = id ? events(*id) : all_events_;
+  if (direction > 0) {
+    auto it = std::ranges::upper_bound(list, cursor_ns, {}, &CanEvent::mono_ns);
+    if (it == list.end()) return false;
+    moveCursorTo((*it)->mono_ns);
+  } else {
+    auto it = std::ranges::lower_bound(list, cursor_ns, {}, &CanEvent::mono_ns);
+    if (it == list.begin()) return false;
+    moveCursorTo((*std::prev(it))->mono_ns);
+  }
+  return true;
+}
+
+void AbstractStream::moveCursorTo(uint64_t mono_ns) {
+  uint64_t cursor_ns;
+  {
+    std::lock_guard lk(mutex_);
+    cursor_ns = shared_state_.cursor_ns;
+  }
+  if (mono_ns == cursor_ns) return;
+
+  bool has_erased = false;
+  if (mono_ns > cursor_ns) {
+    auto first = std::ranges::upper_bound(all_events_, cursor_ns, {}, &CanEvent::mono_ns);
+    auto last = std::ranges::upper_bound(first, all_events_.end(), mono_ns, {}, &CanEvent::mono_ns);
+    processNewMessages(first, last, true);
+  } else {
+    // Rewinding: each message with events in (mono_ns, cursor_ns] goes back to its last event at or before mono_ns
+    auto first = std::ranges::upper_bound(all_events_, mono_ns, {}, &CanEvent::mono_ns);
+    auto last = std::ranges::upper_bound(first, all_events_.end(), cursor_ns, {}, &CanEvent::mono_ns);
+    std::set<MessageId> ids;
+    for (auto it = first; it != last; ++it) ids.insert({(*it)->src, (*it)->address});
+
+    std::lock_guard lk(mutex_);
+    for (const auto& id : ids) {
+      const auto& ev_list = events(id);
+      auto it = std::ranges::upper_bound(ev_list, mono_ns, {}, &CanEvent::mono_ns);
+      if (it == ev_list.begin()) {
+        has_erased |= (shared_state_.master_state.erase(id) > 0);
+        has_erased |= (snapshot_map_.erase(id) > 0);
+        shared_state_.dirty_ids.erase(id);
+        continue;
+      }
+
+      const CanEvent* prev_ev = *std::prev(it);
+      auto& m = shared_state_.master_state[id];
+      m.init(prev_ev->dat, prev_ev->size, toSeconds(prev_ev->mono_ns));
+      m.setDbcMask(getMask(id));
+      m.count = std::distance(ev_list.begin(), it);
+      m.dirty = true;
+      shared_state_.dirty_ids.insert(id);
+    }
+    updateTableUsage();
+  }
+
+  {
+    std::lock_guard lk(mutex_);
+    shared_state_.cursor_ns = mono_ns;
+    shared_state_.current_sec = toSeconds(mono_ns);
+  }
+  setPlaybackPosition(mono_ns);
+  commitSnapshots();
+  if (has_erased) {
+    emit snapshotsUpdated(nullptr, true);
+  }
+}
+
+void AbstractStream::playReverse(bool reverse) {
+  if (reverse == reverse_timer_.isActive()) return;
+
+  if (reverse) {
+    if (!isPaused()) pause(true);
+    reverse_wall_ns_ = nanos_since_boot();
+    reverse_timer_.start(1000 / settings.fps, this);
   } else {
-    state.update(data, size, sec);
+    reverse_timer_.stop();
+  }
+}
+
+void AbstractStream::timerEvent(QTimerEvent* event) {
+  if (event->timerId() != reverse_timer_.timerId()) {
+    QObject::timerEvent(event);
+    return;
   }
 
-  if (!state.dirty) {
-    state.dirty = true;
-    shared_state_.dirty_ids.insert(id);
+  // Forward playback (resume or seek) ends reverse playback
+  if (!isPaused()) {
+    reverse_timer_.stop();
+    return;
   }
+
+  const uint64_t now = nanos_since_boot();
+  const uint64_t elapsed_ns = (now - reverse_wall_ns_) * getSpeed();
+  reverse_wall_ns_ = now;
+
+  uint64_t cursor_ns;
+  {
+    std::lock_guard lk(mutex_);
+    cursor_ns = shared_state_.cursor_ns;
+  }
+  const uint64_t begin_ns = toMonoNs(time_range_ ? time_range_->first : minSeconds());
+  const uint64_t target_ns = cursor_ns > begin_ns + elapsed_ns ? cursor_ns - elapsed_ns : begin_ns;
+  moveCursorTo(target_ns);
+  if (target_ns == begin_ns) reverse_timer_.stop();
 }
 
 const std::vector<const CanEvent*>& AbstractStream::events(const MessageId& id) const {
@@ -111,6 +251,7 @@ void AbstractStream::updateSnapshotsTo(double sec) {
 
   current_sec_ = sec;
   const uint64_t target_ns = toMonoNs(sec);
+  shared_state_.cursor_ns = target_ns;
 
   SourceSet active_sources;
   bool has_erased = false;
@@ -147,6 +288,7 @@ void AbstractStream::updateSnapshotsTo(double sec) {
 
   shared_state_.dirty_ids.clear();
   shared_state_.seek_finished = true;
+  updateTableUsage();
   lk.unlock();
   seek_finished_cv_.notify_one();
 
@@ -162,6 +304,11 @@ void AbstractStream::updateSnapshotsTo(double sec) {
   emit snapshotsUpdated(nullptr, origin_snapshot_size != snapshot_map_.size() || has_erased);
 }
 
+void AbstractStream::updateTableUsage() {
+  states_usage_.set(mem::hashTableBytes(shared_state_.master_state));
+  snapshots_usage_.set(mem::hashTableBytes(snapshot_map_) + snapshot_map_.size() * sizeof(MessageSnapshot));
+}
+
 void AbstractStream::updateActivityStates() {
   const double now = millis_since_boot();
   if (now - last_activity_update_ms_ <= kActivityCheckIntervalMs) return;
@@ -180,7 +327,17 @@ void AbstractStream::waitForSeekFinished() {
 }
 
 const CanEvent* AbstractStream::newEvent(uint64_t mono_ns, uint8_t src, uint32_t address, const uint8_t* data, uint8_t size) {
-  auto* e = static_cast<CanEvent*>(event_buffer_->allocate(sizeof(CanEvent) + sizeof(uint8_t) * size));
+  return newEvent(*event_buffer_, mono_ns, src, address, data, size);
+}
+
+const CanEvent* AbstractStream::newEvent(MonotonicBuffer& buffer, uint64_t mono_ns, const cereal::CanData::Reader& c) {
+  auto dat = c.getDat();
+  return newEvent(buffer, mono_ns, c.getSrc(), c.getAddress(), dat.begin(), dat.size());
+}
+
+const CanEvent* AbstractStream::newEvent(MonotonicBuffer& buffer, uint64_t mono_ns, uint8_t src, uint32_t address,
+                                         const uint8_t* data, uint8_t size) {
+  auto* e = static_cast<CanEvent*>(buffer.allocate(sizeof(CanEvent) + sizeof(uint8_t) * size));
   e->src = src;
   e->address = address;
   e->mono_ns = mono_ns;
@@ -189,15 +346,24 @@ const CanEvent* AbstractStream::newEvent(uint64_t mono_ns, uint8_t src, uint32_t
   return e;
 }
 
+void AbstractStream::adoptEventBuffer(std::unique_ptr<MonotonicBuffer> buffer) {
+  adopted_buffers_.push_back(std::move(buffer));
+}
+
 void AbstractStream::mergeEvents(const std::vector<const CanEvent*>& events) {
   if (events.empty()) return;
+  TRACE_SCOPE("mergeEvents");
+  perf::add(perf::Counter::FramesIngested, events.size());
 
   // 1. Group events by ID
   MessageEventsMap msg_events;
   msg_events.reserve(64);
+  int64_t arena_bytes = 0;
   for (const auto* e : events) {
     msg_events[{e->src, e->address}].push_back(e);
+    arena_bytes += sizeof(CanEvent) + e->size;
   }
+  arena_usage_.add(arena_bytes);
 
   // Helper lambda to insert events while maintaining time order
   auto insert_ordered = [](std::vector<const CanEvent*>& target, const std::vector<const CanEvent*>& new_evs) {
@@ -211,16 +377,30 @@ void AbstractStream::mergeEvents(const std::vector<const CanEvent*>& events) {
   };
 
   // 2. Global list update (O(1) fast-path for live streams)
+  int64_t list_capacity = -(int64_t)all_events_.capacity();
   insert_ordered(all_events_, events);
+  list_capacity += (int64_t)all_events_.capacity();
 
   // 3. Per-ID list and Index update
+  int64_t index_bytes = 0;
   for (auto& [id, new_e] : msg_events) {
     auto& e = events_[id];
+    auto& index = time_index_map_[id];
+    list_capacity -= (int64_t)e.capacity();
+    index_bytes -= (int64_t)index.memoryUsage();
     bool was_append = insert_ordered(e, new_e);
     // Sync the time index (rebuild only if it wasn't a simple append)
-    time_index_map_[id].sync(e, e.front()->mono_ns, e.back()->mono_ns, !was_append);
+    index.sync(e, e.front()->mono_ns, e.back()->mono_ns, !was_append);
+    list_capacity += (int64_t)e.capacity();
+    index_bytes += (int64_t)index.memoryUsage();
   }
-  QTimer::singleShot(0, this, [this, msg_events = std::move(msg_events)]() mutable { emit eventsMerged(msg_events); });
+  event_lists_usage_.add(list_capacity * (int64_t)sizeof(const CanEvent*));
+  time_index_usage_.add(index_bytes);
+  QTimer::singleShot(0, this, [this, msg_events = std::move(msg_events)]() mutable {
+    TRACE_SCOPE("eventsMerged");
+    perf::ScopedTimer perf_timer(perf::Timing::EventsMerged);
+    emit eventsMerged(msg_events);
+  });
 }
 
 std::pair<CanEventIter, CanEventIter> AbstractStream::eventsInRange(
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <QBasicTimer>
 #include <QDateTime>
+#include <QStringList>
 #include <algorithm>
 #include <array>
 #include <condition_variable>
@@ -18,6 +20,7 @@
 #include "message_state.h"
 #include "replay/include/replay.h"
 #include "replay/include/util.h"
+#include "utils/mem_usage.h"
 #include "utils/time_index.h"
 #include "utils/util.h"
 
@@ -51,6 +54,8 @@ class AbstractStream : public QObject {
   virtual double getSpeed() const { return 1; }
   virtual bool isPaused() const { return false; }
   virtual void pause(bool pause) {}
+  // Source specific counters, one line each, shown in the perf panel
+  virtual QStringList statsLines() const { return {}; }
   void setTimeRange(const std::optional<std::pair<double, double>>& range);
   const std::optional<std::pair<double, double>>& timeRange() const { return time_range_; }
 
@@ -72,6 +77,16 @@ class AbstractStream : public QObject {
   std::pair<CanEventIter, CanEventIter> eventsInRange(const MessageId& id,
                                                       std::optional<std::pair<double, double>> time_range) const;
 
+  // Frame stepping: moves to the next (direction > 0) or previous event of `id`, or of any message
+  // when empty, and pauses. Returns false at either end of the stream.
+  bool stepFrame(int direction, std::optional<MessageId> id = std::nullopt);
+  // Moves playback to `mono_ns` without a seek. Only the messages with events in between are
+  // updated, so it is cheap for small moves in either direction.
+  void moveCursorTo(uint64_t mono_ns);
+  // Plays backwards at the current speed, by moving the cursor once per UI frame
+  void playReverse(bool reverse);
+  inline bool isPlayingReverse() const { return reverse_timer_.isActive(); }
+
   size_t suppressHighlighted();
   void clearSuppressed();
   void suppressDefinedSignals(bool suppress);
@@ -96,7 +111,18 @@ class AbstractStream : public QObject {
     return newEvent(mono_ns, c.getSrc(), c.getAddress(), dat.begin(), dat.size());
   }
   const CanEvent* newEvent(uint64_t mono_ns, uint8_t src, uint32_t address, const uint8_t* data, uint8_t size);
-  void processNewMessage(const MessageId& id, uint64_t mono_ns, const uint8_t* data, uint8_t size);
+  // Allocate into an arena owned by the caller, so workers can decode without touching the stream.
+  // The arena has to be handed over with adoptEventBuffer() before its events are merged.
+  static const CanEvent* newEvent(MonotonicBuffer& buffer, uint64_t mono_ns, const cereal::CanData::Reader& c);
+  static const CanEvent* newEvent(MonotonicBuffer& buffer, uint64_t mono_ns, uint8_t src, uint32_t address,
+                                  const uint8_t* data, uint8_t size);
+  void adoptEventBuffer(std::unique_ptr<MonotonicBuffer> buffer);
+  // Feeds a time-ordered run of events to the message states. With `coalesce` (fast playback) only each
+  // message's last event in the run gets pattern and frequency analysis.
+  void processNewMessages(CanEventIter first, CanEventIter last, bool coalesce);
+  // Called after moveCursorTo(), so playback resumes from the new position
+  virtual void setPlaybackPosition(uint64_t mono_ns) {}
+  void timerEvent(QTimerEvent* event) override;
   void waitForSeekFinished();
 
   std::vector<const CanEvent*> all_events_;  // Main thread only
@@ -112,10 +138,12 @@ class AbstractStream : public QObject {
   void updateMessageMask(const MessageId& id);
   const std::vector<uint8_t>& getMask(const MessageId& id) const;
   bool updateSnapshot(const MessageId& id, const MessageState& state);
+  void updateTableUsage();  // Requires mutex_
 
   // Internal state shared between threads, protected by mutex_
   struct SharedState {
     double current_sec = 0;
+    uint64_t cursor_ns = 0;  // Time of the last event applied to master_state
     std::set<MessageId> dirty_ids;
     std::unordered_map<MessageId, MessageState> master_state;
     std::unordered_map<MessageId, std::vector<uint8_t>> masks;
@@ -125,6 +153,8 @@ class AbstractStream : public QObject {
 
   std::mutex mutex_;
   SharedState shared_state_;
+  // Scratch for processNewMessages(), which runs on the playback thread and, when stepping, the main thread
+  std::unordered_map<MessageId, const CanEvent*> coalesce_last_;  // Protected by mutex_
   std::condition_variable seek_finished_cv_;
 
   // All members below are main-thread-only (read/written from Qt event loop)
@@ -132,9 +162,18 @@ class AbstractStream : public QObject {
 
   MessageEventsMap events_;
   std::unique_ptr<MonotonicBuffer> event_buffer_;
+  std::vector<std::unique_ptr<MonotonicBuffer>> adopted_buffers_;
   std::unordered_map<MessageId, TimeIndex<const CanEvent*>> time_index_map_;
 
+  mem::Usage arena_usage_{mem::Pool::EventArena};
+  mem::Usage event_lists_usage_{mem::Pool::EventLists};
+  mem::Usage time_index_usage_{mem::Pool::TimeIndex};
+  mem::Usage states_usage_{mem::Pool::MessageStates};
+  mem::Usage snapshots_usage_{mem::Pool::MessageSnapshots};
+
   double last_activity_update_ms_ = 0;
+  QBasicTimer reverse_timer_;
+  uint64_t reverse_wall_ns_ = 0;
 };
 
 class DummyStream : public AbstractStream {
@@ -0,0 +1,282 @@
+#include "blf_log_stream.h"
+
+#include <zlib.h>
+
+#include <QDebug>
+#include <QFile>
+#include <QThread>
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+
+// Vector Binary Logging Format (BLF):
+//
+//   "LOGG" file header (header_size bytes)
+//   "LOBJ" object, "LOBJ" object, ...
+//
+// Modern loggers wrap the object stream in LOG_CONTAINER objects whose payload is
+// zlib-compressed. Inner objects may span container boundaries, so the decompressed
+// payloads are treated as one continuous byte stream.
+
+namespace {
+
+constexpr uint32_t kCanMessage = 1;
+constexpr uint32_t kLogContainer = 10;
+constexpr uint32_t kCanMessage2 = 86;
+constexpr uint32_t kCanFdMessage = 100;
+constexpr uint32_t kCanFdMessage64 = 101;
+
+constexpr uint16_t kNoCompression = 0;
+constexpr uint16_t kZlibDeflate = 2;
+
+constexpr uint32_t kTimeTenMicros = 0x1;
+constexpr uint32_t kCanIdExtended = 0x80000000;
+constexpr uint8_t kCanRemoteFlag = 0x80;
+constexpr uint32_t kCanFd64RemoteFlag = 0x0010;
+
+constexpr size_t kObjHeaderBaseSize = 16;   // signature, header_size, header_version, object_size, object_type
+constexpr size_t kContainerHeaderSize = 16;  // compression method, reserved, uncompressed size, reserved
+constexpr size_t kMaxQueuedChunks = 8;       // Bounds memory held by decompressed containers in flight
+
+struct __attribute__((packed)) ObjHeaderBase {
+  char signature[4];
+  uint16_t header_size;
+  uint16_t header_version;
+  uint32_t object_size;
+  uint32_t object_type;
+};
+static_assert(sizeof(ObjHeaderBase) == kObjHeaderBaseSize);
+
+template <typename T>
+inline T readLE(const uint8_t* p) {
+  T v;
+  std::memcpy(&v, p, sizeof(T));
+  return v;
+}
+
+inline bool isObjectSignature(const uint8_t* p) { return std::memcmp(p, "LOBJ", 4) == 0; }
+
+// CAN_FD_MESSAGE_64 is the only object type that is not padded to a 4-byte boundary.
+inline size_t paddedObjectSize(const ObjHeaderBase& h) {
+  return h.object_size + (h.object_type == kCanFdMessage64 ? 0 : h.object_size % 4);
+}
+
+// A contiguous slice of the inner object stream. Uncompressed containers are
+// referenced straight from the memory-mapped file; inflated ones own their bytes.
+struct Chunk {
+  std::vector<uint8_t> owned;
+  const uint8_t* data = nullptr;
+  size_t size = 0;
+};
+
+// Bounded single-producer/single-consumer queue between the inflate thread and the parser.
+class ChunkQueue {
+ public:
+  void push(Chunk&& chunk) {
+    std::unique_lock lk(mutex_);
+    not_full_.wait(lk, [this] { return chunks_.size() < kMaxQueuedChunks; });
+    chunks_.push_back(std::move(chunk));
+    not_empty_.notify_one();
+  }
+
+  void finish() {
+    std::lock_guard lk(mutex_);
+    finished_ = true;
+    not_empty_.notify_one();
+  }
+
+  // Returns false once the producer has finished and the queue is drained.
+  bool pop(Chunk& chunk) {
+    std::unique_lock lk(mutex_);
+    not_empty_.wait(lk, [this] { return !chunks_.empty() || finished_; });
+    if (chunks_.empty()) return false;
+    chunk = std::move(chunks_.front());
+    chunks_.pop_front();
+    not_full_.notify_one();
+    return true;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+  std::deque<Chunk> chunks_;
+  bool finished_ = false;
+};
+
+// Walks the top-level objects of the file and feeds the inner object stream to the queue.
+void produceChunks(const uint8_t* base, size_t file_size, size_t offset, ChunkQueue& queue) {
+  size_t pos = offset;
+  while (pos + kObjHeaderBaseSize <= file_size) {
+    if (!isObjectSignature(base + pos)) {
+      ++pos;  // Resync on garbage between objects
+      continue;
+    }
+
+    const auto h = readLE<ObjHeaderBase>(base + pos);
+    if (h.object_size < kObjHeaderBaseSize || pos + h.object_size > file_size) break;
+
+    if (h.object_type == kLogContainer && h.object_size >= kObjHeaderBaseSize + kContainerHeaderSize) {
+      const uint8_t* payload = base + pos + kObjHeaderBaseSize + kContainerHeaderSize;
+      const size_t payload_size = h.object_size - kObjHeaderBaseSize - kContainerHeaderSize;
+      const uint16_t method = readLE<uint16_t>(base + pos + kObjHeaderBaseSize);
+      const uint32_t uncompressed_size = readLE<uint32_t>(base + pos + kObjHeaderBaseSize + 8);
+
+      Chunk chunk;
+      if (method == kNoCompression) {
+        chunk.data = payload;
+        chunk.size = payload_size;
+      } else if (method == kZlibDeflate) {
+        chunk.owned.resize(uncompressed_size);
+        uLongf out_size = uncompressed_size;
+        if (uncompress(chunk.owned.data(), &out_size, payload, payload_size) == Z_OK) {
+          chunk.owned.resize(out_size);
+          chunk.data = chunk.owned.data();
+          chunk.size = chunk.owned.size();
+        } else {
+          // Drop the container, a partly inflated one would feed zeros to the parser
+          qWarning() << "BlfLogStream: failed to inflate container at offset" << pos;
+        }
+      }
+      if (chunk.size > 0) queue.push(std::move(chunk));
+    } else {
+      // Legacy files store objects directly at the top level
+      Chunk chunk;
+      chunk.data = base + pos;
+      chunk.size = std::min(paddedObjectSize(h), file_size - pos);
+      queue.push(std::move(chunk));
+    }
+
+    pos += paddedObjectSize(h);
+  }
+  queue.finish();
+}
+
+void parseCanObject(const uint8_t* obj, const ObjHeaderBase& h, std::vector<ParsedCanFrame>& frames) {
+  if (h.header_size < kObjHeaderBaseSize + 16 || h.header_size > h.object_size) return;
+
+  // Header v1 and v2 both carry the flags at +16 and the timestamp at +24
+  const uint32_t time_flags = readLE<uint32_t>(obj + 16);
+  const uint64_t timestamp = readLE<uint64_t>(obj + 24);
+  const uint8_t* p = obj + h.header_size;
+  const size_t payload_size = h.object_size - h.header_size;
+
+  uint16_t channel = 0;
+  uint32_t id = 0;
+  uint8_t size = 0;
+  const uint8_t* data = nullptr;
+
+  switch (h.object_type) {
+    case kCanMessage:
+    case kCanMessage2: {
+      if (payload_size < 16 || (p[2] & kCanRemoteFlag)) return;
+      channel = readLE<uint16_t>(p);
+      id = readLE<uint32_t>(p + 4);
+      size = std::min<uint8_t>(p[3], 8);
+      data = p + 8;
+      break;
+    }
+    case kCanFdMessage: {
+      if (payload_size < 20 || (p[2] & kCanRemoteFlag)) return;
+      channel = readLE<uint16_t>(p);
+      id = readLE<uint32_t>(p + 4);
+      size = std::min<uint8_t>(p[14], sizeof(ParsedCanFrame::data));
+      data = p + 20;
+      if (payload_size < 20u + size) return;
+      break;
+    }
+    case kCanFdMessage64: {
+      if (payload_size < 40 || (readLE<uint32_t>(p + 12) & kCanFd64RemoteFlag)) return;
+      channel = p[0];
+      id = readLE<uint32_t>(p + 4);
+      size = std::min<uint8_t>(p[2], sizeof(ParsedCanFrame::data));
+      data = p + 40;
+      if (payload_size < 40u + size) return;
+      break;
+    }
+    default:
+      return;
+  }
+
+  ParsedCanFrame& f = frames.emplace_back();
+  f.rel_ns = (time_flags == kTimeTenMicros) ? timestamp * 10'000ULL : timestamp;
+  f.bus = static_cast<uint8_t>(channel > 0 ? channel - 1 : 0);  // BLF channels are 1-based
+  f.address = id & ~kCanIdExtended;
+  f.size = size;
+  std::memcpy(f.data, data, size);
+}
+
+// Parses every complete object in [data, data + size) and returns the number of bytes consumed.
+size_t parseObjects(const uint8_t* data, size_t size, std::vector<ParsedCanFrame>& frames) {
+  size_t pos = 0;
+  while (pos + kObjHeaderBaseSize <= size) {
+    if (!isObjectSignature(data + pos)) {
+      ++pos;
+      continue;
+    }
+
+    const auto h = readLE<ObjHeaderBase>(data + pos);
+    if (h.object_size < kObjHeaderBaseSize) {
+      pos += 4;
+      continue;
+    }
+
+    const size_t next = pos + paddedObjectSize(h);
+    if (next > size) break;  // Object continues in the next chunk
+
+    parseCanObject(data + pos, h, frames);
+    pos = next;
+  }
+  return pos;
+}
+
+}  // namespace
+
+BlfLogStream::BlfLogStream(QObject* parent, const QStringList& file_paths) : FileStream(parent, file_paths) {
+  loadParsedFiles();
+}
+
+std::vector<ParsedCanFrame> BlfLogStream::parseFile(const QString& file_path) {
+  QFile file(file_path);
+  if (!file.open(QIODevice::ReadOnly)) {
+    qWarning() << "BlfLogStream: failed to open" << file_path;
+    return {};
+  }
+
+  const size_t file_size = file.size();
+  const uint8_t* base = file_size > 0 ? file.map(0, file_size) : nullptr;
+  if (!base || file_size < 144 || std::memcmp(base, "LOGG", 4) != 0) {
+    qWarning() << "BlfLogStream: not a BLF file" << file_path;
+    return {};
+  }
+
+  const uint32_t header_size = readLE<uint32_t>(base + 4);
+  const uint32_t object_count = readLE<uint32_t>(base + 32);
+
+  std::vector<ParsedCanFrame> frames;
+  frames.reserve(std::min<size_t>(object_count, file_size));
+
+  // Inflate containers on a background thread while this thread parses the objects
+  ChunkQueue queue;
+  QThread* inflate_thread = QThread::create([&]() { produceChunks(base, file_size, header_size, queue); });
+  inflate_thread->start();
+
+  std::vector<uint8_t> carry;  // Tail of an object that spans two chunks
+  Chunk chunk;
+  while (queue.pop(chunk)) {
+    if (carry.empty()) {
+      size_t consumed = parseObjects(chunk.data, chunk.size, frames);
+      carry.assign(chunk.data + consumed, chunk.data + chunk.size);
+    } else {
+      carry.insert(carry.end(), chunk.data, chunk.data + chunk.size);
+      size_t consumed = parseObjects(carry.data(), carry.size(), frames);
+      carry.erase(carry.begin(), carry.begin() + consumed);
+    }
+  }
+
+  inflate_thread->wait();
+  delete inflate_thread;
+  return frames;
+}
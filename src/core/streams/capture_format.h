@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+
+// Cabana capture (.ccap), the native format live streams are recorded to.
+//
+//   FileHeader
+//   BlockHeader + payload            repeated, in time order
+//   BlockIndexEntry[block_count]     written when the capture is closed
+//   MessageIndexEntry[message_count]
+//   Trailer
+//
+// A block payload holds `count` frames as columns: uint64 rel_ns[], uint32 address[],
+// uint8 src[], uint8 size[], followed by the data bytes of all frames back to back.
+// The payload is optionally zstd-compressed as a whole and padded to a multiple of 8 bytes,
+// so every header in the file stays aligned. Timestamps are nanoseconds
+// relative to FileHeader::begin_ns. All values are little-endian.
+// The index lets a reader decode blocks on demand: the block time ranges locate a time, the
+// message index locates the blocks a message appears in.
+// A capture without a trailer, e.g. after a crash, is still read by walking the blocks.
+
+namespace capture {
+
+constexpr char kFileMagic[8] = {'C', 'A', 'B', 'A', 'N', 'A', 'C', 'P'};
+constexpr char kTrailerMagic[8] = {'C', 'A', 'B', 'I', 'N', 'D', 'E', 'X'};
+constexpr uint32_t kBlockMagic = 0x4b4c4243;  // "CBLK"
+constexpr uint32_t kVersion = 1;
+
+enum Compression : uint32_t {
+  kUncompressed = 0,
+  kZstd = 1,
+};
+
+struct FileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t reserved;
+  uint64_t begin_ns;        // Monotonic time of the first frame
+  int64_t begin_epoch_ms;   // Wall-clock time of the first frame
+};
+
+struct BlockHeader {
+  uint32_t magic;
+  uint32_t count;
+  uint64_t t_min;           // rel_ns of the first and last frame
+  uint64_t t_max;
+  uint32_t raw_size;
+  uint32_t stored_size;
+  uint32_t compression;
+  uint32_t reserved;
+};
+
+struct BlockIndexEntry {
+  uint64_t offset;          // File offset of the BlockHeader
+  uint64_t t_min;
+  uint64_t t_max;
+  uint32_t count;           // Must match the block, a mismatch means the index is stale
+  uint32_t reserved;
+};
+
+struct MessageIndexEntry {
+  uint32_t address;
+  uint8_t src;
+  uint8_t reserved[3];
+  uint32_t count;
+  uint32_t first_block;     // Indices into the block index of the first and last block holding the message
+  uint32_t last_block;
+};
+
+struct Trailer {
+  uint64_t index_offset;    // File offset of the first BlockIndexEntry
+  uint32_t block_count;
+  uint32_t message_count;
+  char magic[8];
+};
+
+static_assert(sizeof(FileHeader) == 32);
+static_assert(sizeof(BlockHeader) == 40);
+static_assert(sizeof(BlockIndexEntry) == 32);
+static_assert(sizeof(MessageIndexEntry) == 20);
+static_assert(sizeof(Trailer) == 24);
+
+// Size of the uncompressed columns for `count` frames, excluding the data bytes
+constexpr uint64_t columnsSize(uint32_t count) { return uint64_t(count) * (sizeof(uint64_t) + sizeof(uint32_t) + 2); }
+constexpr uint64_t paddedSize(uint64_t size) { return (size + 7) & ~uint64_t(7); }
+
+}  // namespace capture
@@ -0,0 +1,274 @@
+#include "capture_stream.h"
+
+#include <zstd.h>
+
+#include <QDebug>
+#include <QTimer>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cstring>
+#include <set>
+
+// Files are memory-mapped and only their trailer index is read when opening. The block time ranges
+// find the blocks around a time, which are decoded in parallel and merged into the timeline. After a
+// seek the message index finds, for every message, the block holding its last value before the target.
+
+namespace {
+
+constexpr double kDecodeAheadSec = 30.0;  // Kept decoded around the playback position
+constexpr double kDecodeBehindSec = 5.0;
+constexpr int kDecodeIntervalMs = 250;
+
+const capture::BlockHeader* blockAt(const uint8_t* base, size_t size, uint64_t offset) {
+  if (offset % alignof(capture::BlockHeader) != 0 || offset > size || size - offset < sizeof(capture::BlockHeader)) {
+    return nullptr;
+  }
+
+  auto* header = reinterpret_cast<const capture::BlockHeader*>(base + offset);
+  const uint64_t payload_end = offset + sizeof(capture::BlockHeader) + capture::paddedSize(header->stored_size);
+  if (header->magic != capture::kBlockMagic || payload_end > size ||
+      header->raw_size < capture::columnsSize(header->count)) {
+    return nullptr;
+  }
+  return header;
+}
+
+// Reads the trailer index. Returns false if there is none or it does not match the blocks.
+bool readIndex(const uint8_t* base, size_t size, std::vector<capture::BlockIndexEntry>& blocks,
+               std::vector<capture::MessageIndexEntry>& messages) {
+  if (size < sizeof(capture::FileHeader) + sizeof(capture::Trailer)) return false;
+
+  capture::Trailer trailer;
+  std::memcpy(&trailer, base + size - sizeof(trailer), sizeof(trailer));
+  const uint64_t blocks_size = uint64_t(trailer.block_count) * sizeof(capture::BlockIndexEntry);
+  const uint64_t messages_size = uint64_t(trailer.message_count) * sizeof(capture::MessageIndexEntry);
+  if (std::memcmp(trailer.magic, capture::kTrailerMagic, sizeof(trailer.magic)) != 0 || trailer.index_offset > size ||
+      trailer.index_offset + blocks_size + messages_size > size - sizeof(trailer)) {
+    return false;
+  }
+
+  blocks.resize(trailer.block_count);
+  std::memcpy(blocks.data(), base + trailer.index_offset, blocks_size);
+  messages.resize(trailer.message_count);
+  std::memcpy(messages.data(), base + trailer.index_offset + blocks_size, messages_size);
+
+  for (const auto& entry : blocks) {
+    auto* header = blockAt(base, size, entry.offset);
+    if (!header || header->count != entry.count) return false;
+  }
+  return std::ranges::all_of(messages, [&](const auto& m) {
+    return m.first_block <= m.last_block && m.last_block < blocks.size();
+  });
+}
+
+bool decodeBlock(const capture::BlockHeader& header, const uint8_t* payload, std::vector<ParsedCanFrame>& frames) {
+  std::vector<uint8_t> inflated;
+  const uint8_t* raw = payload;
+  if (header.compression == capture::kZstd) {
+    inflated.resize(header.raw_size);
+    size_t n = ZSTD_decompress(inflated.data(), inflated.size(), payload, header.stored_size);
+    if (ZSTD_isError(n) || n != header.raw_size) {
+      qWarning() << "CaptureStream: corrupt block with" << header.count << "frames";
+      return false;
+    }
+    raw = inflated.data();
+  } else if (header.compression != capture::kUncompressed || header.stored_size != header.raw_size) {
+    return false;
+  }
+
+  const uint32_t count = header.count;
+  const uint8_t* ts_col = raw;
+  const uint8_t* address_col = ts_col + count * sizeof(uint64_t);
+  const uint8_t* src_col = address_col + count * sizeof(uint32_t);
+  const uint8_t* size_col = src_col + count;
+  const uint8_t* data = size_col + count;
+  const uint8_t* end = raw + header.raw_size;
+
+  frames.resize(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    ParsedCanFrame& f = frames[i];
+    std::memcpy(&f.rel_ns, ts_col + i * sizeof(uint64_t), sizeof(uint64_t));
+    std::memcpy(&f.address, address_col + i * sizeof(uint32_t), sizeof(uint32_t));
+    f.bus = src_col[i];
+    f.size = std::min<size_t>(size_col[i], sizeof(f.data));
+    if (data + size_col[i] > end) return false;
+
+    std::memcpy(f.data, data, f.size);
+    data += size_col[i];
+  }
+  return true;
+}
+
+}  // namespace
+
+CaptureStream::CaptureStream(QObject* parent, const QStringList& file_paths) : FileStream(parent, file_paths) {
+  for (const QString& file_path : file_paths_) {
+    openFile(file_path);
+  }
+  if (blocks_.empty()) return;
+
+  duration_s_ = blocks_.back().t_max / 1e9;
+  decodeBlocks(unindexed_blocks_);
+  decodeRange(0, kDecodeAheadSec);
+
+  // Keep up with playback, and decode what the charts are zoomed into
+  auto* timer = new QTimer(this);
+  timer->setInterval(kDecodeIntervalMs);
+  connect(timer, &QTimer::timeout, this,
+          [this]() { decodeRange(currentSec() - kDecodeBehindSec, currentSec() + kDecodeAheadSec); });
+  timer->start();
+  connect(this, &AbstractStream::timeRangeChanged, this, [this](const std::optional<std::pair<double, double>>& range) {
+    if (range) decodeRange(range->first, range->second);
+  });
+}
+
+void CaptureStream::openFile(const QString& file_path) {
+  auto file = std::make_unique<QFile>(file_path);
+  if (!file->open(QIODevice::ReadOnly)) {
+    qWarning() << "CaptureStream: failed to open" << file_path;
+    return;
+  }
+
+  const size_t size = file->size();
+  const uint8_t* base = size >= sizeof(capture::FileHeader) ? file->map(0, size) : nullptr;
+  if (!base || std::memcmp(base, capture::kFileMagic, sizeof(capture::kFileMagic)) != 0) {
+    qWarning() << "CaptureStream: not a Cabana capture" << file_path;
+    return;
+  }
+
+  capture::FileHeader file_header;
+  std::memcpy(&file_header, base, sizeof(file_header));
+  if (!begin_date_time_.isValid() && file_header.begin_epoch_ms > 0) {
+    begin_date_time_ = QDateTime::fromMSecsSinceEpoch(file_header.begin_epoch_ms);
+  }
+
+  std::vector<capture::BlockIndexEntry> index;
+  std::vector<capture::MessageIndexEntry> message_index;
+  const bool indexed = readIndex(base, size, index, message_index);
+  if (!indexed) {
+    // No index, the recording was interrupted. Walk the blocks up to the first incomplete one.
+    index.clear();
+    uint64_t offset = sizeof(capture::FileHeader);
+    while (auto* header = blockAt(base, size, offset)) {
+      index.push_back({offset, header->t_min, header->t_max, header->count, 0});
+      offset += sizeof(*header) + capture::paddedSize(header->stored_size);
+    }
+  }
+  if (index.empty()) return;
+
+  // Stitch like loadParsedFiles(): if this file's timestamps restart, it follows the previous file by 1 ms
+  uint64_t shift_ns = 0;
+  if (!blocks_.empty() && index.front().t_min <= blocks_.back().t_max) {
+    shift_ns = blocks_.back().t_max + 1'000'000ULL - index.front().t_min;
+  }
+
+  const uint32_t first = blocks_.size();
+  for (const auto& entry : index) {
+    auto* header = reinterpret_cast<const capture::BlockHeader*>(base + entry.offset);
+    blocks_.push_back({header, base + entry.offset + sizeof(*header), shift_ns, entry.t_min + shift_ns,
+                       entry.t_max + shift_ns});
+    if (!indexed) unindexed_blocks_.push_back(blocks_.size() - 1);
+  }
+  for (const auto& m : message_index) {
+    messages_[MessageId{m.src, m.address}].push_back({first + m.first_block, first + m.last_block});
+  }
+  files_.push_back(std::move(file));
+}
+
+void CaptureStream::seekTo(double sec) {
+  sec = std::clamp(sec, 0.0, duration_s_);
+  decodeRange(sec - kDecodeBehindSec, sec + kDecodeAheadSec);
+  decodeLastEventsAt(sec);
+  FileStream::seekTo(sec);
+}
+
+QStringList CaptureStream::statsLines() const {
+  return {tr("Capture: %1 of %2 blocks decoded").arg(decoded_blocks_).arg(blocks_.size())};
+}
+
+void CaptureStream::decodeAll() { decodeRange(0, duration_s_); }
+
+void CaptureStream::decodeRange(double from_sec, double to_sec) {
+  const uint64_t from_ns = std::max(from_sec, 0.0) * 1e9;
+  const uint64_t to_ns = std::max(to_sec, 0.0) * 1e9;
+  auto first = std::ranges::lower_bound(blocks_, from_ns, {}, &Block::t_max);
+  auto last = std::ranges::upper_bound(first, blocks_.end(), to_ns, {}, &Block::t_min);
+
+  std::vector<uint32_t> indices;
+  for (auto it = first; it != last; ++it) {
+    if (!it->decoded) indices.push_back(std::distance(blocks_.begin(), it));
+  }
+  decodeBlocks(indices);
+}
+
+// `indices` must be in ascending order
+void CaptureStream::decodeBlocks(const std::vector<uint32_t>& indices) {
+  struct Job {
+    uint32_t block;
+    std::vector<ParsedCanFrame> frames;
+    bool ok;
+  };
+  std::vector<Job> jobs;
+  for (uint32_t i : indices) {
+    if (!blocks_[i].decoded) jobs.push_back({i, {}, false});
+  }
+  if (jobs.empty()) return;
+
+  QtConcurrent::blockingMap(jobs, [this](Job& job) {
+    const Block& block = blocks_[job.block];
+    job.ok = decodeBlock(*block.header, block.payload, job.frames);
+  });
+
+  std::vector<const CanEvent*> events;
+  for (size_t i = 0; i < jobs.size(); ++i) {
+    Block& block = blocks_[jobs[i].block];
+    block.decoded = true;
+    ++decoded_blocks_;
+    if (jobs[i].ok) {
+      for (const auto& f : jobs[i].frames) {
+        events.push_back(newEvent(begin_mono_ns_ + block.shift_ns + f.rel_ns, f.bus, f.address, f.data, f.size));
+      }
+    }
+
+    // A run of adjacent blocks fills one gap in the timeline, so it is merged in one go
+    if (i + 1 == jobs.size() || jobs[i + 1].block != jobs[i].block + 1) {
+      mergeTimeline(events);
+      events.clear();
+    }
+  }
+}
+
+void CaptureStream::decodeLastEventsAt(double sec) {
+  const uint64_t target_ns = toMonoNs(sec);
+  auto after = std::ranges::upper_bound(blocks_, target_ns - begin_mono_ns_, {}, &Block::t_min);
+  if (after == blocks_.begin()) return;
+  const uint32_t target_block = std::distance(blocks_.begin(), after) - 1;
+
+  // One block usually holds the last value of many messages, so blocks are decoded in rounds
+  for (std::set<uint32_t> needed;; needed.clear()) {
+    for (const auto& [id, spans] : messages_) {
+      if (auto block = blockToDecode(id, spans, target_block, target_ns)) needed.insert(*block);
+    }
+    if (needed.empty()) break;
+    decodeBlocks({needed.begin(), needed.end()});
+  }
+}
+
+// Walks back from the target block through the blocks the message appears in. Returns the first
+// one that is not decoded yet, or nothing once the block holding its last event at target_ns is.
+std::optional<uint32_t> CaptureStream::blockToDecode(const MessageId& id, const std::vector<MessageSpan>& spans,
+                                                     uint32_t target_block, uint64_t target_ns) const {
+  const auto& evs = events(id);
+  auto it = std::ranges::upper_bound(evs, target_ns, {}, &CanEvent::mono_ns);
+  const bool has_last = it != evs.begin();
+  const uint64_t last_ns = has_last ? (*std::prev(it))->mono_ns - begin_mono_ns_ : 0;
+
+  for (auto span = spans.rbegin(); span != spans.rend(); ++span) {
+    if (span->first_block > target_block) continue;
+    for (int64_t k = std::min(target_block, span->last_block); k >= span->first_block; --k) {
+      if (!blocks_[k].decoded) return static_cast<uint32_t>(k);
+      if (has_last && last_ns >= blocks_[k].t_min) return std::nullopt;
+    }
+  }
+  return std::nullopt;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <QDateTime>
+#include <QFile>
+#include <QStringList>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "capture_format.h"
+#include "file_stream.h"
+
+// Reopens Cabana captures (.ccap) recorded by live streams. Only the trailer index is read when
+// opening; blocks are decoded once playback, a seek or the visible time range reaches them.
+class CaptureStream : public FileStream {
+  Q_OBJECT
+
+ public:
+  CaptureStream(QObject* parent, const QStringList& file_paths);
+  QDateTime beginDateTime() const override { return begin_date_time_; }
+  void seekTo(double sec) override;
+  QStringList statsLines() const override;
+  // For consumers that need every event at once, such as the CLI
+  void decodeAll();
+  size_t decodedBlocks() const { return decoded_blocks_; }
+  size_t blockCount() const { return blocks_.size(); }
+
+ private:
+  struct Block {
+    const capture::BlockHeader* header;
+    const uint8_t* payload;
+    uint64_t shift_ns;  // Places the block's file on the stream timeline
+    uint64_t t_min;     // Time range of the block on the stream timeline, from begin_mono_ns_
+    uint64_t t_max;
+    bool decoded = false;
+  };
+
+  // First and last block of one file that a message appears in, as indices into blocks_
+  struct MessageSpan {
+    uint32_t first_block;
+    uint32_t last_block;
+  };
+
+  void openFile(const QString& file_path);
+  void decodeRange(double from_sec, double to_sec);
+  void decodeBlocks(const std::vector<uint32_t>& indices);
+  // Decodes what is needed to know the last value of every message at `sec`
+  void decodeLastEventsAt(double sec);
+  std::optional<uint32_t> blockToDecode(const MessageId& id, const std::vector<MessageSpan>& spans,
+                                        uint32_t target_block, uint64_t target_ns) const;
+
+  std::vector<std::unique_ptr<QFile>> files_;  // Kept open, blocks point into their mappings
+  std::vector<Block> blocks_;                  // All files, in time order
+  std::unordered_map<MessageId, std::vector<MessageSpan>> messages_;
+  std::vector<uint32_t> unindexed_blocks_;     // Of captures that were cut off, decoded when opening
+  size_t decoded_blocks_ = 0;
+  QDateTime begin_date_time_;  // Of the first file
+};
@@ -0,0 +1,186 @@
+#include "capture_writer.h"
+
+#include <unistd.h>
+#include <zstd.h>
+
+#include <QDateTime>
+#include <QDebug>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "common/timing.h"
+
+namespace {
+
+constexpr size_t kBlockFrames = 4096;
+constexpr auto kFlushInterval = std::chrono::seconds(1);  // Bounds what a crash can lose
+constexpr int kZstdLevel = 3;
+
+template <typename T>
+void putColumn(uint8_t* column, size_t i, T value) {
+  std::memcpy(column + i * sizeof(T), &value, sizeof(T));
+}
+
+}  // namespace
+
+CaptureWriter::CaptureWriter(const QString& path, bool compress) : path_(path), compress_(compress) {
+  file_ = std::fopen(path_.toStdString().c_str(), "wb");
+  if (!file_) {
+    qWarning() << "CaptureWriter: failed to open" << path_;
+    return;
+  }
+  block_.reserve(kBlockFrames);
+  writer_thread_ = QThread::create([this]() { writerThread(); });
+  writer_thread_->start();
+}
+
+CaptureWriter::~CaptureWriter() {
+  if (!writer_thread_) return;
+
+  {
+    std::lock_guard lk(mutex_);
+    exit_ = true;
+  }
+  cv_.notify_one();
+  writer_thread_->wait();
+  delete writer_thread_;
+}
+
+void CaptureWriter::append(const std::vector<const CanEvent*>& events) {
+  if (!writer_thread_ || events.empty()) return;
+
+  {
+    std::lock_guard lk(mutex_);
+    queue_.insert(queue_.end(), events.begin(), events.end());
+  }
+  cv_.notify_one();
+}
+
+void CaptureWriter::writerThread() {
+  std::vector<const CanEvent*> events;
+  bool exiting = false;
+  while (!exiting) {
+    {
+      std::unique_lock lk(mutex_);
+      // A partial block is written after a quiet second, so little is lost if cabana dies
+      bool woken = cv_.wait_for(lk, kFlushInterval, [this]() { return exit_ || !queue_.empty(); });
+      events.swap(queue_);
+      exiting = exit_;
+      if (!woken) {
+        lk.unlock();
+        flushBlock();
+        continue;
+      }
+    }
+
+    for (const CanEvent* e : events) {
+      block_.push_back(e);
+      if (block_.size() == kBlockFrames) flushBlock();
+    }
+    events.clear();
+  }
+  flushBlock();
+  finish();
+}
+
+void CaptureWriter::flushBlock() {
+  if (block_.empty()) return;
+
+  if (offset_ == 0) {
+    const CanEvent* first = block_.front();
+    capture::FileHeader header = {};
+    std::memcpy(header.magic, capture::kFileMagic, sizeof(header.magic));
+    header.version = capture::kVersion;
+    header.begin_ns = begin_ns_ = first->mono_ns;
+    header.begin_epoch_ms =
+        QDateTime::currentMSecsSinceEpoch() - (int64_t)(nanos_since_boot() - first->mono_ns) / 1000000;
+    std::fwrite(&header, sizeof(header), 1, file_);
+    offset_ = sizeof(header);
+  }
+
+  // Columns first, data bytes after; similar values sit next to each other and compress well
+  const uint32_t count = block_.size();
+  size_t data_size = 0;
+  for (const CanEvent* e : block_) data_size += e->size;
+  raw_.resize(capture::columnsSize(count) + data_size);
+
+  uint8_t* ts_col = raw_.data();
+  uint8_t* address_col = ts_col + count * sizeof(uint64_t);
+  uint8_t* src_col = address_col + count * sizeof(uint32_t);
+  uint8_t* size_col = src_col + count;
+  uint8_t* data = size_col + count;
+  const uint32_t block_index = blocks_.size();
+  auto rel_ns = [this](const CanEvent* e) { return std::max(e->mono_ns, begin_ns_) - begin_ns_; };
+  for (uint32_t i = 0; i < count; ++i) {
+    const CanEvent* e = block_[i];
+    putColumn<uint64_t>(ts_col, i, rel_ns(e));
+    putColumn<uint32_t>(address_col, i, e->address);
+    src_col[i] = e->src;
+    size_col[i] = e->size;
+    std::memcpy(data, e->dat, e->size);
+    data += e->size;
+
+    auto [it, inserted] = messages_.try_emplace(MessageId{e->src, e->address});
+    auto& entry = it->second;
+    if (inserted) {
+      entry.address = e->address;
+      entry.src = e->src;
+      entry.first_block = block_index;
+    }
+    entry.count++;
+    entry.last_block = block_index;
+  }
+
+  capture::BlockHeader header = {};
+  header.magic = capture::kBlockMagic;
+  header.count = count;
+  header.t_min = rel_ns(block_.front());
+  header.t_max = rel_ns(block_.back());
+  header.raw_size = raw_.size();
+  header.compression = capture::kUncompressed;
+  const uint8_t* payload = raw_.data();
+  header.stored_size = raw_.size();
+
+  if (compress_) {
+    compressed_.resize(ZSTD_compressBound(raw_.size()));
+    size_t n = ZSTD_compress(compressed_.data(), compressed_.size(), raw_.data(), raw_.size(), kZstdLevel);
+    if (!ZSTD_isError(n) && n < raw_.size()) {
+      header.compression = capture::kZstd;
+      header.stored_size = n;
+      payload = compressed_.data();
+    }
+  }
+
+  blocks_.push_back({offset_, header.t_min, header.t_max, count, 0});
+  std::fwrite(&header, sizeof(header), 1, file_);
+  std::fwrite(payload, header.stored_size, 1, file_);
+  const uint64_t padded = capture::paddedSize(header.stored_size);
+  const uint8_t zeros[8] = {};
+  std::fwrite(zeros, padded - header.stored_size, 1, file_);
+  std::fflush(file_);
+  offset_ += sizeof(header) + padded;
+  block_.clear();
+}
+
+// Appends the index and makes the capture durable
+void CaptureWriter::finish() {
+  if (offset_ > 0) {
+    capture::Trailer trailer = {};
+    trailer.index_offset = offset_;
+    trailer.block_count = blocks_.size();
+    trailer.message_count = messages_.size();
+    std::memcpy(trailer.magic, capture::kTrailerMagic, sizeof(trailer.magic));
+
+    std::fwrite(blocks_.data(), sizeof(capture::BlockIndexEntry), blocks_.size(), file_);
+    for (const auto& [id, entry] : messages_) {
+      std::fwrite(&entry, sizeof(entry), 1, file_);
+    }
+    std::fwrite(&trailer, sizeof(trailer), 1, file_);
+  }
+
+  std::fflush(file_);
+  ::fsync(fileno(file_));
+  std::fclose(file_);
+  file_ = nullptr;
+}
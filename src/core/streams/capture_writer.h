@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QString>
+#include <QThread>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "abstract_stream.h"
+#include "capture_format.h"
+
+// Records events to a Cabana capture (see capture_format.h) on a background thread.
+// Only event pointers cross threads; the events must outlive the writer.
+class CaptureWriter {
+ public:
+  CaptureWriter(const QString& path, bool compress);
+  ~CaptureWriter();
+
+  // Main thread. Events are expected in time order.
+  void append(const std::vector<const CanEvent*>& events);
+
+ private:
+  void writerThread();
+  void flushBlock();
+  void finish();
+
+  const QString path_;
+  const bool compress_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<const CanEvent*> queue_;
+  bool exit_ = false;
+  QThread* writer_thread_ = nullptr;
+
+  // Writer thread state
+  std::FILE* file_ = nullptr;
+  uint64_t begin_ns_ = 0;
+  uint64_t offset_ = 0;
+  std::vector<const CanEvent*> block_;
+  std::vector<uint8_t> raw_;
+  std::vector<uint8_t> compressed_;
+  std::vector<capture::BlockIndexEntry> blocks_;
+  std::unordered_map<MessageId, capture::MessageIndexEntry> messages_;
+};
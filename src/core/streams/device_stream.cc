@@ -5,33 +5,65 @@
 #include "cereal/services.h"
 #include "cereal/messaging/impl_zmq.h"
 
+// Upper bound on how long the stream thread blocks before checking for interruption
+static constexpr int POLL_TIMEOUT_MS = 100;
+
 DeviceStream::DeviceStream(QObject* parent, QString address) : LiveStream(parent), zmq_address(address) {}
 
+DeviceStream::Stats DeviceStream::stats() const {
+  return {wakeups.load(), messages.load(), max_batch.load(), empty_wakeups.load()};
+}
+
+QStringList DeviceStream::statsLines() const {
+  const Stats s = stats();
+  return LiveStream::statsLines() << tr("Device: %1 messages in %2 wakeups, max batch %3, %4 empty wakeups")
+                                         .arg(s.messages)
+                                         .arg(s.wakeups)
+                                         .arg(s.max_batch)
+                                         .arg(s.empty_wakeups);
+}
+
 void DeviceStream::streamThread() {
   zmq_address.isEmpty() ? unsetenv("ZMQ") : setenv("ZMQ", "1", 1);
 
-
   std::unique_ptr<Context> context;
   std::string address = zmq_address.isEmpty() ? "127.0.0.1" : zmq_address.toStdString();
   std::unique_ptr<SubSocket> sock;
+  std::unique_ptr<Poller> poller;
 
   if (zmq_address.isEmpty()) {
     context.reset(Context::create());
     sock.reset(SubSocket::create(context.get(), "can", address, false, true, services.at("can").queue_size));
+    poller.reset(Poller::create());
   } else {
     context.reset(new ZMQContext());
     sock.reset(new ZMQSubSocket());
     sock->connect(context.get(), "can", address, false, true, services.at("can").queue_size);
+    poller.reset(new ZMQPoller());
   }
   assert(sock != NULL);
+  poller->registerSocket(sock.get());
 
-  // run as fast as messages come in
+  // Block until messages arrive, then drain everything pending into one batch
+  std::vector<const CanEvent*> batch;
   while (!QThread::currentThread()->isInterruptionRequested()) {
-    std::unique_ptr<Message> msg(sock->receive(true));
-    if (!msg) {
-      QThread::msleep(50);
-      continue;
+    if (poller->poll(POLL_TIMEOUT_MS).empty()) continue;
+
+    batch.clear();
+    uint64_t count = 0;
+    while (std::unique_ptr<Message> msg{sock->receive(true)}) {
+      decodeEvent(kj::ArrayPtr<capnp::word>((capnp::word*)msg->getData(), msg->getSize() / sizeof(capnp::word)), batch);
+      ++count;
+    }
+    queueEvents(batch);
+
+    ++wakeups;
+    messages += count;
+    if (count == 0) {
+      // msgq resets a reader that fell too far behind, which shows up as a wakeup with nothing to read
+      ++empty_wakeups;
+    } else if (count > max_batch) {
+      max_batch = count;
     }
-    handleEvent(kj::ArrayPtr<capnp::word>((capnp::word*)msg->getData(), msg->getSize() / sizeof(capnp::word)));
   }
 }
@@ -1,16 +1,32 @@
 #pragma once
 
+#include <atomic>
+
 #include "live_stream.h"
 
 class DeviceStream : public LiveStream {
   Q_OBJECT
  public:
+  struct Stats {
+    uint64_t wakeups;
+    uint64_t messages;
+    uint64_t max_batch;      // Most messages drained in a single wakeup
+    uint64_t empty_wakeups;  // Wakeups where the socket was ready but had nothing to read
+  };
+
   DeviceStream(QObject* parent, QString address = {});
   inline QString routeName() const override {
     return QString("Live Streaming From %1").arg(zmq_address.isEmpty() ? "127.0.0.1" : zmq_address);
   }
+  Stats stats() const;
+  QStringList statsLines() const override;
 
  protected:
   void streamThread() override;
   const QString zmq_address;
+
+  std::atomic<uint64_t> wakeups{0};
+  std::atomic<uint64_t> messages{0};
+  std::atomic<uint64_t> max_batch{0};
+  std::atomic<uint64_t> empty_wakeups{0};
 };
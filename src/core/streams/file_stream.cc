@@ -6,6 +6,7 @@
 
 #include "common/timing.h"
 #include "modules/settings/settings.h"
+#include "utils/trace.h"
 
 FileStream::FileStream(QObject* parent, const QStringList& file_paths)
     : AbstractStream(parent), file_paths_(file_paths) {
@@ -32,7 +33,11 @@ void FileStream::loadParsedFiles() {
   std::vector<ParsedCanFrame> all_parsed;
 
   for (const QString& file_path : file_paths_) {
-    auto file_frames = parseFile(file_path);
+    std::vector<ParsedCanFrame> file_frames;
+    {
+      TRACE_SCOPE("parseFile");
+      file_frames = parseFile(file_path);
+    }
     if (file_frames.empty()) continue;
 
     // Stitch: if this file's timestamps restart (overlap with already-parsed frames),
@@ -47,9 +52,11 @@ void FileStream::loadParsedFiles() {
                       std::make_move_iterator(file_frames.end()));
   }
 
-  // Sort handles files provided out of order.
-  std::sort(all_parsed.begin(), all_parsed.end(),
-            [](const ParsedCanFrame& a, const ParsedCanFrame& b) { return a.rel_ns < b.rel_ns; });
+  // Sort handles files provided out of order. Most inputs are already in order, checking is cheaper.
+  auto by_time = [](const ParsedCanFrame& a, const ParsedCanFrame& b) { return a.rel_ns < b.rel_ns; };
+  if (!std::is_sorted(all_parsed.begin(), all_parsed.end(), by_time)) {
+    std::sort(all_parsed.begin(), all_parsed.end(), by_time);
+  }
 
   std::vector<const CanEvent*> events;
   events.reserve(all_parsed.size());
@@ -67,9 +74,13 @@ void FileStream::start() {
   if (all_events_.empty()) return;
 
   auto* timer = new QTimer(this);
-  timer->setInterval(1000 / settings.fps);
+  ui_interval_ms_ = 1000 / settings.fps;
+  timer->setInterval(ui_interval_ms_);
   connect(timer, &QTimer::timeout, this, [this]() { commitSnapshots(); });
-  connect(&settings, &Settings::changed, this, [timer]() { timer->setInterval(1000 / settings.fps); });
+  connect(&settings, &Settings::changed, this, [this, timer]() {
+    ui_interval_ms_ = 1000 / settings.fps;
+    timer->setInterval(ui_interval_ms_);
+  });
   timer->start();
 
   playback_thread_ = QThread::create([this]() { playbackThread(); });
@@ -77,11 +88,15 @@ void FileStream::start() {
 }
 
 void FileStream::seekTo(double sec) {
+  cursor_to_.store(0);
   seek_to_.store(std::clamp(sec, 0.0, duration_s_));
   pause_cv_.notify_all();
   emit seeking(sec);
 }
 
+// Picked up by the playback thread when it next runs, i.e. on resume
+void FileStream::setPlaybackPosition(uint64_t mono_ns) { cursor_to_.store(mono_ns); }
+
 void FileStream::pause(bool pause) {
   {
     std::lock_guard lk(pause_mutex_);
@@ -96,27 +111,43 @@ void FileStream::setSpeed(float speed) {
   pause_cv_.notify_all();
 }
 
+void FileStream::mergeTimeline(const std::vector<const CanEvent*>& events) {
+  {
+    std::lock_guard lk(pause_mutex_);
+    mergeEvents(events);
+  }
+  pause_cv_.notify_all();
+}
+
 void FileStream::playbackThread() {
-  size_t idx = 0;
+  trace::setThreadName("File playback");
+  // The position is the time of the last played event rather than an index into the timeline,
+  // so it stays valid when mergeTimeline() inserts events.
+  uint64_t played_ns = 0;
   uint64_t anchor_wall_ns = nanos_since_boot();  // wall-clock at last anchor
   uint64_t anchor_file_ns = 0;                    // file-time progress (ns from begin_mono_ns_) at last anchor
   float prev_speed = 1.0f;
 
+  // Held whenever the timeline is read, released while sleeping or waiting
+  std::unique_lock lk(pause_mutex_);
+  auto next = [&]() { return std::ranges::upper_bound(all_events_, played_ns, {}, &CanEvent::mono_ns); };
+
   // Re-anchor wall clock and file-time base at the current playback position.
   // Must be called after any discontinuity: seek, pause/unpause, speed change.
   auto reanchor = [&]() {
     anchor_wall_ns = nanos_since_boot();
-    anchor_file_ns = (idx < all_events_.size()) ? (all_events_[idx]->mono_ns - begin_mono_ns_) : anchor_file_ns;
+    auto it = next();
+    anchor_file_ns = (it != all_events_.end()) ? ((*it)->mono_ns - begin_mono_ns_) : anchor_file_ns;
   };
 
   auto applySeek = [&](double sec) {
-    uint64_t target_ns = begin_mono_ns_ + static_cast<uint64_t>(sec * 1e9);
-    auto it = std::lower_bound(all_events_.begin(), all_events_.end(), target_ns,
-                               [](const CanEvent* e, uint64_t t) { return e->mono_ns < t; });
-    idx = std::distance(all_events_.begin(), it);
+    played_ns = begin_mono_ns_ + static_cast<uint64_t>(sec * 1e9) - 1;
     reanchor();
+    // The main thread rebuilds the state meanwhile, which may merge events
+    lk.unlock();
     emit seekedTo(sec);
     waitForSeekFinished();
+    lk.lock();
   };
 
   applySeek(0.0);
@@ -128,9 +159,13 @@ void FileStream::playbackThread() {
       continue;
     }
 
+    if (uint64_t cursor = cursor_to_.exchange(0); cursor != 0) {
+      played_ns = cursor;
+      reanchor();
+    }
+
     // Block while paused — wakes on unpause, seek, or destruction
     if (paused_.load()) {
-      std::unique_lock lk(pause_mutex_);
       pause_cv_.wait(lk, [&] {
         return !paused_.load() || seek_to_.load() >= 0.0 || QThread::currentThread()->isInterruptionRequested();
       });
@@ -138,10 +173,15 @@ void FileStream::playbackThread() {
       continue;
     }
 
-    if (idx >= all_events_.size()) {
-      // End of file — block until seek or destruction
-      std::unique_lock lk(pause_mutex_);
-      pause_cv_.wait(lk, [&] { return seek_to_.load() >= 0.0 || QThread::currentThread()->isInterruptionRequested(); });
+    const CanEventIter first = next();
+    if (first == all_events_.cend()) {
+      // End of the timeline — block until seek, more events, or destruction
+      const size_t size = all_events_.size();
+      pause_cv_.wait(lk, [&] {
+        return seek_to_.load() >= 0.0 || all_events_.size() != size ||
+               QThread::currentThread()->isInterruptionRequested();
+      });
+      reanchor();
       continue;
     }
 
@@ -154,18 +194,33 @@ void FileStream::playbackThread() {
 
     // How far into the file we should be (in ns from begin_mono_ns_)
     const uint64_t file_time_ns = anchor_file_ns + static_cast<uint64_t>((nanos_since_boot() - anchor_wall_ns) * spd);
-    const uint64_t event_file_ns = all_events_[idx]->mono_ns - begin_mono_ns_;
+    const uint64_t event_file_ns = (*first)->mono_ns - begin_mono_ns_;
 
     if (event_file_ns > file_time_ns) {
       uint64_t wait_ns = std::min<uint64_t>(static_cast<uint64_t>((event_file_ns - file_time_ns) / spd), 50'000'000ULL);
+      lk.unlock();
       QThread::usleep(wait_ns / 1000);
+      lk.lock();
       continue;
     }
 
-    while (idx < all_events_.size()) {
-      if (all_events_[idx]->mono_ns - begin_mono_ns_ > file_time_ns) break;
-      const CanEvent* e = all_events_[idx++];
-      processNewMessage({e->src, e->address}, e->mono_ns, e->dat, e->size);
+    // Everything due by now, up to the boundary found by binary search over the timeline
+    const auto last = std::upper_bound(first, all_events_.cend(), begin_mono_ns_ + file_time_ns,
+                                       [](uint64_t t, const CanEvent* e) { return t < e->mono_ns; });
+
+    // pause() takes the same lock, so once it returns no batch is in flight and none starts until
+    // resume. Frame stepping and reverse playback then own the cursor on the main thread.
+    if (seek_to_.load() >= 0.0) continue;
+    played_ns = (*std::prev(last))->mono_ns;
+
+    // Above real time the UI only samples the state once per frame, so there is no point in waking
+    // for every event. Jump a whole UI frame at a time and only analyze what can be displayed.
+    const bool fast_forward = spd > 1.0f;
+    processNewMessages(first, last, fast_forward);
+    if (fast_forward) {
+      lk.unlock();
+      QThread::msleep(ui_interval_ms_.load());
+      lk.lock();
     }
   }
 }
@@ -40,13 +40,17 @@ class FileStream : public AbstractStream {
   double getSpeed() const override { return speed_; }
 
  protected:
-  // Subclasses implement this to parse a single file into ParsedCanFrames.
+  // Subclasses that load whole files implement this to parse a single file into ParsedCanFrames.
   // Timestamps should be file-relative nanoseconds (from 0).
   // The base class handles stitching, sorting, and event allocation.
-  virtual std::vector<ParsedCanFrame> parseFile(const QString& file_path) = 0;
+  virtual std::vector<ParsedCanFrame> parseFile(const QString& file_path) { return {}; }
+  void setPlaybackPosition(uint64_t mono_ns) override;
 
   // Call from subclass constructor after parsing to build the event timeline.
   void loadParsedFiles();
+  // Main thread. For subclasses that load on demand: adds time-ordered events to the timeline,
+  // also while it is being played.
+  void mergeTimeline(const std::vector<const CanEvent*>& events);
 
   QStringList file_paths_;
   uint64_t begin_mono_ns_ = 0;
@@ -57,8 +61,10 @@ class FileStream : public AbstractStream {
 
   QThread* playback_thread_ = nullptr;
   std::atomic<double> seek_to_{-1.0};
+  std::atomic<uint64_t> cursor_to_{0};  // Set by frame stepping, 0 if none
   std::atomic<bool> paused_{false};
   std::atomic<float> speed_{1.0f};
-  std::mutex pause_mutex_;
+  std::atomic<int> ui_interval_ms_{50};  // Snapshot commit interval, paces fast-forward playback
+  std::mutex pause_mutex_;  // Also held while the playback thread reads the timeline
   std::condition_variable pause_cv_;
 };
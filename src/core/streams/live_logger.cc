@@ -0,0 +1,183 @@
+#include "live_logger.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <zstd.h>
+
+#include <QDateTime>
+#include <QDebug>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "common/timing.h"
+#include "common/util.h"
+
+static constexpr size_t RING_SIZE = 16 * 1024 * 1024;   // 16MB, must be a power of two
+static constexpr size_t BATCH_SIZE = 1024 * 1024;       // Flush to disk after this many bytes
+static constexpr int ZSTD_LEVEL = 3;                    // Fast enough to keep up with a busy bus
+static constexpr unsigned long IDLE_SLEEP_MS = 10;
+
+LiveLogger::LiveLogger(const QString& log_path, bool compress)
+    : log_path_(log_path), compress_(compress), start_ts_(seconds_since_epoch()) {
+  ring_ = std::make_unique<char[]>(RING_SIZE);
+  batch_.reserve(BATCH_SIZE + 64 * 1024);
+  if (compress_) {
+    zstd_ctx_ = ZSTD_createCCtx();
+    ZSTD_CCtx_setParameter(zstd_ctx_, ZSTD_c_compressionLevel, ZSTD_LEVEL);
+    zstd_out_.resize(ZSTD_CStreamOutSize());
+  }
+  writer_thread_ = QThread::create([this]() { writerThread(); });
+  writer_thread_->start();
+}
+
+LiveLogger::~LiveLogger() {
+  exit_ = true;
+  writer_thread_->wait();
+  delete writer_thread_;
+  if (zstd_ctx_) ZSTD_freeCCtx(zstd_ctx_);
+}
+
+void LiveLogger::write(kj::ArrayPtr<capnp::word> data) {
+  auto bytes = data.asBytes();
+  const size_t size = sizeof(RecordHeader) + bytes.size();
+  const uint64_t head = head_.load(std::memory_order_relaxed);
+  if (RING_SIZE - (head - tail_.load(std::memory_order_acquire)) < size) {
+    ++dropped_messages_;
+    dropped_bytes_ += bytes.size();
+    return;
+  }
+
+  // Segments rotate every minute of wall-clock time since the logger started
+  RecordHeader header = {(uint32_t)bytes.size(), (int32_t)((seconds_since_epoch() - start_ts_) / 60)};
+  copyIn(head, &header, sizeof(header));
+  copyIn(head + sizeof(header), bytes.begin(), bytes.size());
+  head_.store(head + size, std::memory_order_release);
+}
+
+LiveLogger::Stats LiveLogger::stats() const {
+  return {written_messages_.load(), written_bytes_.load(), dropped_messages_.load(), dropped_bytes_.load()};
+}
+
+void LiveLogger::copyIn(uint64_t pos, const void* src, size_t size) {
+  const size_t offset = pos & (RING_SIZE - 1);
+  const size_t first = std::min(size, RING_SIZE - offset);
+  memcpy(&ring_[offset], src, first);
+  memcpy(&ring_[0], (const char*)src + first, size - first);
+}
+
+void LiveLogger::copyOut(uint64_t pos, void* dst, size_t size) const {
+  const size_t offset = pos & (RING_SIZE - 1);
+  const size_t first = std::min(size, RING_SIZE - offset);
+  memcpy(dst, &ring_[offset], first);
+  memcpy((char*)dst + first, &ring_[0], size - first);
+}
+
+void LiveLogger::writerThread() {
+  while (true) {
+    // Read exit_ before head_ so everything written before shutdown is drained
+    const bool exiting = exit_.load();
+    const uint64_t head = head_.load(std::memory_order_acquire);
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+
+    while (tail < head) {
+      RecordHeader header;
+      copyOut(tail, &header, sizeof(header));
+      if (header.segment != segment_) {
+        writeOut(batch_.data(), batch_.size(), false);
+        batch_.clear();
+        closeSegment();
+        openSegment(header.segment);
+      }
+
+      const size_t offset = batch_.size();
+      batch_.resize(offset + header.size);
+      copyOut(tail + sizeof(header), &batch_[offset], header.size);
+      tail += sizeof(header) + header.size;
+      ++written_messages_;
+      written_bytes_ += header.size;
+
+      if (batch_.size() >= BATCH_SIZE) {
+        tail_.store(tail, std::memory_order_release);
+        writeOut(batch_.data(), batch_.size(), false);
+        batch_.clear();
+      }
+    }
+    tail_.store(tail, std::memory_order_release);
+    writeOut(batch_.data(), batch_.size(), false);
+    batch_.clear();
+
+    if (uint64_t drops = dropped_messages_.load(); drops != reported_drops_) {
+      qWarning() << "LiveLogger: disk too slow, dropped" << (drops - reported_drops_) << "messages";
+      reported_drops_ = drops;
+    }
+
+    if (exiting) break;
+    if (tail == head) QThread::msleep(IDLE_SLEEP_MS);
+  }
+  closeSegment();
+}
+
+void LiveLogger::openSegment(int segment) {
+  segment_ = segment;
+  QString dir = QString("%1/%2--%3")
+                    .arg(log_path_)
+                    .arg(QDateTime::fromSecsSinceEpoch(start_ts_).toString("yyyy-MM-dd--hh-mm-ss"))
+                    .arg(segment);
+  util::create_directories(dir.toStdString(), 0755);
+  QString path = dir + (compress_ ? "/rlog.zst" : "/rlog");
+  fd_ = ::open(path.toStdString().c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd_ < 0) {
+    qWarning() << "LiveLogger: failed to open" << path << strerror(errno);
+  }
+  if (zstd_ctx_) {
+    ZSTD_CCtx_reset(zstd_ctx_, ZSTD_reset_session_only);
+  }
+}
+
+// Flushes the segment to stable storage, so a finished segment survives a crash or power loss
+void LiveLogger::closeSegment() {
+  if (segment_ < 0) return;
+
+  writeOut(nullptr, 0, true);
+  if (fd_ >= 0) {
+    ::fsync(fd_);
+    ::close(fd_);
+    fd_ = -1;
+  }
+  segment_ = -1;
+}
+
+void LiveLogger::writeOut(const char* data, size_t size, bool end_of_segment) {
+  if (!zstd_ctx_) {
+    writeFully(data, size);
+    return;
+  }
+  if (size == 0 && !end_of_segment) return;
+
+  ZSTD_inBuffer in = {data, size, 0};
+  const ZSTD_EndDirective mode = end_of_segment ? ZSTD_e_end : ZSTD_e_continue;
+  size_t remaining;
+  do {
+    ZSTD_outBuffer out = {zstd_out_.data(), zstd_out_.size(), 0};
+    remaining = ZSTD_compressStream2(zstd_ctx_, &out, &in, mode);
+    if (ZSTD_isError(remaining)) {
+      qWarning() << "LiveLogger: compression failed" << ZSTD_getErrorName(remaining);
+      return;
+    }
+    writeFully(zstd_out_.data(), out.pos);
+  } while (end_of_segment ? remaining != 0 : in.pos < in.size);
+}
+
+void LiveLogger::writeFully(const char* data, size_t size) {
+  while (fd_ >= 0 && size > 0) {
+    ssize_t n = ::write(fd_, data, size);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      qWarning() << "LiveLogger: write failed" << strerror(errno);
+      return;
+    }
+    data += n;
+    size -= n;
+  }
+}
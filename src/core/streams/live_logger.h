@@ -0,0 +1,69 @@
+#pragma once
+
+#include <QString>
+#include <QThread>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "cereal/messaging/messaging.h"
+
+struct ZSTD_CCtx_s;
+
+// Writes live stream messages to rlog segments on a background thread.
+// The stream thread only copies each message into a lock-free single-producer ring buffer,
+// so a slow disk drops messages instead of stalling capture.
+class LiveLogger {
+ public:
+  struct Stats {
+    uint64_t written_messages;
+    uint64_t written_bytes;
+    uint64_t dropped_messages;
+    uint64_t dropped_bytes;
+  };
+
+  LiveLogger(const QString& log_path, bool compress);
+  ~LiveLogger();
+
+  // Called from the stream thread. Never blocks.
+  void write(kj::ArrayPtr<capnp::word> data);
+  Stats stats() const;
+
+ private:
+  struct RecordHeader {
+    uint32_t size;
+    int32_t segment;
+  };
+
+  void writerThread();
+  void copyIn(uint64_t pos, const void* src, size_t size);
+  void copyOut(uint64_t pos, void* dst, size_t size) const;
+  void openSegment(int segment);
+  void closeSegment();
+  void writeOut(const char* data, size_t size, bool end_of_segment);
+  void writeFully(const char* data, size_t size);
+
+  const QString log_path_;
+  const bool compress_;
+  const uint64_t start_ts_;
+
+  // Ring buffer; head_ is only written by the producer, tail_ only by the writer thread
+  std::unique_ptr<char[]> ring_;
+  std::atomic<uint64_t> head_{0};
+  std::atomic<uint64_t> tail_{0};
+
+  std::atomic<uint64_t> written_messages_{0};
+  std::atomic<uint64_t> written_bytes_{0};
+  std::atomic<uint64_t> dropped_messages_{0};
+  std::atomic<uint64_t> dropped_bytes_{0};
+  uint64_t reported_drops_ = 0;
+
+  // Writer thread state
+  QThread* writer_thread_ = nullptr;
+  std::atomic<bool> exit_{false};
+  int fd_ = -1;
+  int segment_ = -1;
+  ZSTD_CCtx_s* zstd_ctx_ = nullptr;
+  std::vector<char> batch_;
+  std::vector<char> zstd_out_;
+};
@@ -1,51 +1,43 @@
 #include "live_stream.h"
 
+#include <QDebug>
 #include <QThread>
 #include <QTimerEvent>
 #include <algorithm>
-#include <fstream>
 #include <memory>
 
 #include "common/timing.h"
 #include "common/util.h"
 #include "modules/settings/settings.h"
-
-struct LiveStream::Logger {
-  Logger() : start_ts(seconds_since_epoch()), segment_num(-1) {}
-
-  void write(kj::ArrayPtr<capnp::word> data) {
-    int n = (seconds_since_epoch() - start_ts) / 60.0;
-    if (segment_num != n) {
-      segment_num = n;
-      QString dir = QString("%1/%2--%3")
-                        .arg(settings.log_path)
-                        .arg(QDateTime::fromSecsSinceEpoch(start_ts).toString("yyyy-MM-dd--hh-mm-ss"))
-                        .arg(n);
-      util::create_directories(dir.toStdString(), 0755);
-      fs.reset(new std::ofstream((dir + "/rlog").toStdString(), std::ios::binary | std::ios::out));
-    }
-
-    auto bytes = data.asBytes();
-    fs->write((const char*)bytes.begin(), bytes.size());
-  }
-
-  std::unique_ptr<std::ofstream> fs;
-  int segment_num;
-  uint64_t start_ts;
-};
+#include "utils/perf.h"
+#include "utils/trace.h"
 
 LiveStream::LiveStream(QObject* parent) : AbstractStream(parent) {
   if (settings.log_livestream) {
-    logger_ = std::make_unique<Logger>();
+    logger_ = std::make_unique<LiveLogger>(settings.log_path, settings.log_compress);
+    if (settings.log_capture) {
+      util::create_directories(settings.log_path.toStdString(), 0755);
+      QString path = QString("%1/%2.ccap").arg(settings.log_path).arg(
+          QDateTime::currentDateTime().toString("yyyy-MM-dd--hh-mm-ss"));
+      capture_writer_ = std::make_unique<CaptureWriter>(path, settings.log_compress);
+    }
   }
   stream_thread_ = new QThread(this);
 
   connect(&settings, &Settings::changed, this, &LiveStream::startFrameTimer);
-  connect(stream_thread_, &QThread::started, [this]() { streamThread(); });
+  connect(stream_thread_, &QThread::started, [this]() {
+    trace::setThreadName("Live stream");
+    streamThread();
+  });
   connect(stream_thread_, &QThread::finished, stream_thread_, &QThread::deleteLater);
 }
 
-LiveStream::~LiveStream() { stop(); }
+LiveStream::~LiveStream() {
+  stop();
+  if (auto s = loggerStats(); s && s->written_messages + s->dropped_messages > 0) {
+    qInfo() << "LiveLogger:" << s->written_messages << "messages written," << s->dropped_messages << "dropped";
+  }
+}
 
 void LiveStream::start() {
   stream_thread_->start();
@@ -63,6 +55,21 @@ void LiveStream::stop() {
   stream_thread_ = nullptr;
 }
 
+std::optional<LiveLogger::Stats> LiveStream::loggerStats() const {
+  if (!logger_) return std::nullopt;
+  return logger_->stats();
+}
+
+QStringList LiveStream::statsLines() const {
+  auto s = loggerStats();
+  if (!s) return {};
+  return {tr("Logger: %1 messages (%2 MB) written, %3 messages (%4 MB) dropped")
+              .arg(s->written_messages)
+              .arg(s->written_bytes / 1e6, 0, 'f', 1)
+              .arg(s->dropped_messages)
+              .arg(s->dropped_bytes / 1e6, 0, 'f', 1)};
+}
+
 void LiveStream::startFrameTimer() {
   frame_timer_.stop();
   frame_timer_.start(1000.0 / settings.fps, this);
@@ -70,6 +77,14 @@ void LiveStream::startFrameTimer() {
 
 // Called from the stream thread
 void LiveStream::handleEvent(kj::ArrayPtr<capnp::word> data) {
+  std::vector<const CanEvent*> events;
+  decodeEvent(data, events);
+  queueEvents(events);
+}
+
+// Called from the stream thread
+void LiveStream::decodeEvent(kj::ArrayPtr<capnp::word> data, std::vector<const CanEvent*>& events) {
+  TRACE_SCOPE("decodeEvent");
   if (logger_) {
     logger_->write(data);
   }
@@ -78,16 +93,49 @@ void LiveStream::handleEvent(kj::ArrayPtr<capnp::word> data) {
   auto event = reader.getRoot<cereal::Event>();
   if (event.which() == cereal::Event::Which::CAN) {
     const uint64_t mono_ns = event.getLogMonoTime();
-    std::lock_guard lk(recv_mutex_);
     for (const auto& c : event.getCan()) {
-      recv_queue_.push_back(newEvent(mono_ns, c));
+      events.push_back(newEvent(mono_ns, c));
     }
   }
 }
 
+// Called from the stream thread
+void LiveStream::queueEvents(const std::vector<const CanEvent*>& events) {
+  if (events.empty()) return;
+
+  std::lock_guard lk(recv_mutex_);
+  recv_queue_.insert(recv_queue_.end(), events.begin(), events.end());
+}
+
+// Called from the stream thread
+void LiveStream::handleEvents(const std::vector<const CanEvent*>& events) {
+  if (events.empty()) return;
+  TRACE_SCOPE("handleEvents");
+
+  if (logger_) {
+    // One Event per timestamp, so a replayed log keeps the receive time of every frame
+    for (auto first = events.begin(); first != events.end();) {
+      const uint64_t mono_ns = (*first)->mono_ns;
+      auto last = std::find_if(first, events.end(), [mono_ns](const CanEvent* e) { return e->mono_ns != mono_ns; });
+
+      MessageBuilder msg;
+      auto evt = msg.initEvent();
+      evt.setLogMonoTime(mono_ns);
+      auto can_data = evt.initCan(std::distance(first, last));
+      for (uint32_t i = 0; first != last; ++first, ++i) {
+        can_data[i].setAddress((*first)->address);
+        can_data[i].setSrc((*first)->src);
+        can_data[i].setDat(kj::arrayPtr((*first)->dat, (*first)->size));
+      }
+      logger_->write(capnp::messageToFlatArray(msg));
+    }
+  }
+  queueEvents(events);
+}
+
 void LiveStream::timerEvent(QTimerEvent* event) {
   if (event->timerId() != frame_timer_.timerId()) {
-    QObject::timerEvent(event);
+    AbstractStream::timerEvent(event);
     return;
   }
 
@@ -99,13 +147,16 @@ void LiveStream::timerEvent(QTimerEvent* event) {
 }
 
 void LiveStream::drainQueue() {
+  TRACE_SCOPE("drainQueue");
   std::vector<const CanEvent*> batch;
   {
     std::lock_guard lk(recv_mutex_);
     batch.swap(recv_queue_);
   }
+  perf::set(perf::Gauge::QueueDepth, batch.size());
   if (!batch.empty()) {
     mergeEvents(batch);
+    if (capture_writer_) capture_writer_->append(batch);
     latest_ns_ = std::max(latest_ns_, batch.back()->mono_ns);
   }
 }
@@ -123,10 +174,9 @@ void LiveStream::advancePlayback() {
   auto first = std::ranges::upper_bound(all_events_, cursor_ns_, {}, &CanEvent::mono_ns);
   auto last = std::ranges::upper_bound(first, all_events_.end(), target, {}, &CanEvent::mono_ns);
 
-  for (auto it = first; it != last; ++it) {
-    const CanEvent* e = *it;
-    processNewMessage({e->src, e->address}, e->mono_ns, e->dat, e->size);
-    cursor_ns_ = e->mono_ns;
+  if (first != last) {
+    processNewMessages(first, last, speed_ > 1.0);
+    cursor_ns_ = (*std::prev(last))->mono_ns;
   }
 
   at_live_edge_ = (cursor_ns_ >= latest_ns_);
@@ -161,6 +211,12 @@ void LiveStream::seekTo(double sec) {
   emit seekedTo((cursor_ns_ - begin_ns_) / 1e9);
 }
 
+void LiveStream::setPlaybackPosition(uint64_t mono_ns) {
+  cursor_ns_ = mono_ns;
+  at_live_edge_ = false;
+  resetAnchor();
+}
+
 void LiveStream::pause(bool pause) {
   if (paused_ != pause) {
     paused_ = pause;
@@ -6,6 +6,8 @@
 #include <vector>
 
 #include "abstract_stream.h"
+#include "capture_writer.h"
+#include "live_logger.h"
 
 class LiveStream : public AbstractStream {
   Q_OBJECT
@@ -23,10 +25,21 @@ class LiveStream : public AbstractStream {
   bool isPaused() const override { return paused_; }
   void pause(bool pause) override;
   void seekTo(double sec) override;
+  // Empty when live stream logging is disabled
+  std::optional<LiveLogger::Stats> loggerStats() const;
+  QStringList statsLines() const override;
 
  protected:
+  void setPlaybackPosition(uint64_t mono_ns) override;
   virtual void streamThread() = 0;
   void handleEvent(kj::ArrayPtr<capnp::word> event);
+  // Logs a serialized event and appends its CAN frames to `events` without queueing them.
+  // Lets sources that receive several messages at once hand them over with queueEvents().
+  void decodeEvent(kj::ArrayPtr<capnp::word> event, std::vector<const CanEvent*>& events);
+  void queueEvents(const std::vector<const CanEvent*>& events);
+  // For sources that allocate events directly via newEvent(). Events must be in time order.
+  // They are only serialized to capnp when live stream logging is enabled, one Event per timestamp.
+  void handleEvents(const std::vector<const CanEvent*>& events);
 
  private:
   void startFrameTimer();
@@ -59,6 +72,6 @@ class LiveStream : public AbstractStream {
   bool paused_ = false;
   bool at_live_edge_ = true;  // At speed=1.0, skip clock math and process all events
 
-  struct Logger;
-  std::unique_ptr<Logger> logger_;
+  std::unique_ptr<LiveLogger> logger_;
+  std::unique_ptr<CaptureWriter> capture_writer_;
 };
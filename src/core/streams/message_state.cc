@@ -24,6 +24,7 @@ void MessageState::init(const uint8_t* new_data, uint8_t data_size, double curre
   count = 1;
   freq = 0;
   last_freq_ts = current_ts;
+  skipped_since_freq = 0;
 
   std::memcpy(data.data(), new_data, size);
   std::memset(data.data() + size, 0, MAX_CAN_LEN - size);
@@ -77,21 +78,44 @@ void MessageState::update(const uint8_t* new_data, uint8_t data_size, double cur
   }
 }
 
+void MessageState::skip(const uint8_t* new_data, uint8_t data_size, double current_ts) {
+  if (size != data_size) {
+    init(new_data, data_size, current_ts);
+    return;
+  }
+
+  ts = current_ts;
+  count++;
+  skipped_since_freq++;
+  for (int i = 0; i < size; ++i) {
+    if (const uint8_t xor_bits = new_data[i] ^ data[i]; xor_bits != 0) {
+      for (uint8_t bits = xor_bits; bits != 0; bits &= bits - 1) {
+        const int bit = 7 - std::countr_zero(bits);
+        bit_flips[i][bit]++;
+        bit_change_ts_[i][bit] = current_ts;
+      }
+      data[i] = new_data[i];
+    }
+  }
+}
+
 void MessageState::updateFrequency(double current_ts, double manual_freq, bool is_seek) {
   if (manual_freq > 0) {
     freq = manual_freq;
   } else if (is_seek || last_freq_ts == 0) {
     last_freq_ts = current_ts;
+    skipped_since_freq = 0;
   } else {
     double interval = current_ts - last_freq_ts;
     if (interval > FREQ_JITTER_THRESHOLD) {
-      double instant_freq = 1.0 / interval;
+      double instant_freq = (1 + skipped_since_freq) / interval;
       // Adaptive EMA: heavy smoothing for fast msgs, fast response for slow msgs
       double alpha = (interval < 0.1) ? 0.1 : 0.6;
       freq = (freq == 0.0) ? instant_freq : (freq * (1.0 - alpha)) + (instant_freq * alpha);
     }
     if (interval >= 0) {
       last_freq_ts = current_ts;
+      skipped_since_freq = 0;
     }
   }
 }
@@ -19,6 +19,8 @@ class MessageState {
  public:
   void init(const uint8_t* new_data, uint8_t data_size, double current_ts);
   void update(const uint8_t* new_data, uint8_t data_size, double current_ts, double manual_freq = 0, bool is_seek = false);
+  // Cheap update for frames that are never displayed: payload, count and bit flips only
+  void skip(const uint8_t* new_data, uint8_t data_size, double current_ts);
   BytePatternInfo bytePattern(int byte_idx) const;
   const auto& combinedMask() const { return mask_; }
   void setDbcMask(const std::vector<uint8_t>& mask);
@@ -53,6 +55,7 @@ class MessageState {
   static constexpr double kMuteActivityWindowSec = 2.0;
 
   double last_freq_ts = 0;
+  uint32_t skipped_since_freq = 0;  // Frames passed to skip() since last_freq_ts
   std::array<ByteAnalysis, MAX_CAN_LEN> analysis = {};
   std::array<std::array<double, 8>, MAX_CAN_LEN> bit_change_ts_ = {};
   std::array<uint8_t, MAX_CAN_LEN> dbc_mask_ = {};
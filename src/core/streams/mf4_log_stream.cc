@@ -0,0 +1,512 @@
+#include "mf4_log_stream.h"
+
+#include <zlib.h>
+
+#include <QDebug>
+#include <QFile>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <unordered_map>
+
+// ASAM MDF 4.x bus logging reader (CAN_DataFrame channel groups).
+//
+// Every block starts with a 24-byte header ("##XX", reserved, length, link count)
+// followed by its links and data section. The reader walks HD -> DG -> CG -> CN to
+// locate the CAN_DataFrame composition channels, then indexes the group's data
+// blocks through DL/HL lists and inflates DZ blocks in parallel batches.
+
+namespace {
+
+constexpr size_t kBlockHeaderSize = 24;
+constexpr size_t kIdBlockSize = 64;
+constexpr size_t kParallelBlocks = 32;  // Data blocks inflated per QtConcurrent batch
+constexpr size_t kMaxChainLength = 1 << 20;  // Guards against cyclic links in corrupt files
+
+constexpr uint8_t kChannelVlsd = 1;
+constexpr uint8_t kChannelMaster = 2;
+constexpr uint8_t kSyncTime = 1;
+
+constexpr uint8_t kUintBE = 1;
+constexpr uint8_t kIntLE = 2;
+constexpr uint8_t kIntBE = 3;
+constexpr uint8_t kFloatLE = 4;
+constexpr uint8_t kFloatBE = 5;
+
+constexpr uint16_t kGroupVlsd = 0x1;
+constexpr uint8_t kZipTransposeDeflate = 1;
+constexpr uint8_t kConversionLinear = 1;
+
+constexpr uint8_t kDlcToLen[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64};
+
+template <typename T>
+inline T readLE(const uint8_t* p) {
+  T v;
+  std::memcpy(&v, p, sizeof(T));
+  return v;
+}
+
+struct Block {
+  char type[2] = {};  // "DT" for "##DT"
+  const uint8_t* links = nullptr;
+  uint64_t link_count = 0;
+  const uint8_t* data = nullptr;
+  uint64_t data_size = 0;
+
+  bool is(const char* t) const { return type[0] == t[0] && type[1] == t[1]; }
+  uint64_t link(uint64_t i) const { return i < link_count ? readLE<uint64_t>(links + i * 8) : 0; }
+
+  template <typename T>
+  T field(size_t offset) const {
+    return offset + sizeof(T) <= data_size ? readLE<T>(data + offset) : T{};
+  }
+};
+
+struct MdfFile {
+  const uint8_t* base = nullptr;
+  uint64_t size = 0;
+
+  bool block(uint64_t offset, Block& b) const {
+    if (offset == 0 || offset > size || size - offset < kBlockHeaderSize) return false;
+    const uint8_t* p = base + offset;
+    if (p[0] != '#' || p[1] != '#') return false;
+
+    const uint64_t length = readLE<uint64_t>(p + 8);
+    const uint64_t link_count = readLE<uint64_t>(p + 16);
+    if (length < kBlockHeaderSize || length > size - offset || link_count > (length - kBlockHeaderSize) / 8) return false;
+
+    b.type[0] = p[2];
+    b.type[1] = p[3];
+    b.links = p + kBlockHeaderSize;
+    b.link_count = link_count;
+    b.data = b.links + link_count * 8;
+    b.data_size = length - kBlockHeaderSize - link_count * 8;
+    return true;
+  }
+
+  QString text(uint64_t offset) const {
+    Block b;
+    if (!block(offset, b) || !b.is("TX")) return {};
+    const char* s = reinterpret_cast<const char*>(b.data);
+    return QString::fromUtf8(s, strnlen(s, b.data_size));
+  }
+};
+
+// A decoded data block. DT/SD blocks are referenced in place from the mapped file;
+// DZ blocks own their inflated bytes.
+struct Chunk {
+  std::vector<uint8_t> owned;
+  const uint8_t* data = nullptr;
+  size_t size = 0;
+};
+
+// Reverses the DZ byte transposition: the first rows*columns bytes are stored column by column.
+void untranspose(std::vector<uint8_t>& buf, uint32_t columns) {
+  const size_t rows = buf.size() / columns;
+  if (rows < 2) return;
+
+  std::vector<uint8_t> out(buf.size());
+  for (size_t c = 0; c < columns; ++c) {
+    for (size_t r = 0; r < rows; ++r) {
+      out[r * columns + c] = buf[c * rows + r];
+    }
+  }
+  std::copy(buf.begin() + rows * columns, buf.end(), out.begin() + rows * columns);
+  buf.swap(out);
+}
+
+Chunk decodeBlock(const Block& b) {
+  Chunk chunk;
+  if (b.is("DT") || b.is("SD")) {
+    chunk.data = b.data;
+    chunk.size = b.data_size;
+  } else if (b.is("DZ") && b.data_size >= 24) {
+    // dz_org_block_type[2], dz_zip_type, reserved, dz_zip_parameter, dz_org_data_length, dz_data_length
+    const uint8_t zip_type = b.data[2];
+    const uint32_t zip_parameter = readLE<uint32_t>(b.data + 4);
+    const uint64_t org_length = readLE<uint64_t>(b.data + 8);
+    const uint64_t zip_length = std::min<uint64_t>(readLE<uint64_t>(b.data + 16), b.data_size - 24);
+
+    chunk.owned.resize(org_length);
+    uLongf out_size = org_length;
+    if (uncompress(chunk.owned.data(), &out_size, b.data + 24, zip_length) != Z_OK) {
+      qWarning() << "Mf4LogStream: failed to inflate DZ block";
+      return {};
+    }
+    chunk.owned.resize(out_size);
+    if (zip_type == kZipTransposeDeflate && zip_parameter > 1) {
+      untranspose(chunk.owned, zip_parameter);
+    }
+    chunk.data = chunk.owned.data();
+    chunk.size = chunk.owned.size();
+  }
+  return chunk;
+}
+
+// Flattens the DT/SD/DZ leaves referenced directly or through an HL/DL chain into file order.
+void collectDataBlocks(const MdfFile& f, uint64_t offset, std::vector<Block>& out) {
+  Block b;
+  if (!f.block(offset, b)) return;
+  if (b.is("HL")) {
+    collectDataBlocks(f, b.link(0), out);
+  } else if (b.is("DL")) {
+    for (size_t n = 0; n < kMaxChainLength && f.block(offset, b) && b.is("DL"); ++n, offset = b.link(0)) {
+      const uint32_t count = b.field<uint32_t>(4);
+      for (uint64_t i = 1; i <= count && i < b.link_count; ++i) {
+        Block leaf;
+        if (f.block(b.link(i), leaf)) out.push_back(leaf);
+      }
+    }
+  } else {
+    out.push_back(b);
+  }
+}
+
+// Decodes blocks in parallel batches and hands each chunk to `sink` in file order.
+// Batching bounds the inflated bytes held in memory at once.
+template <typename Sink>
+void forEachChunk(const std::vector<Block>& blocks, Sink&& sink) {
+  std::vector<std::pair<const Block*, Chunk>> jobs;
+  for (size_t i = 0; i < blocks.size(); i += kParallelBlocks) {
+    jobs.clear();
+    for (size_t j = i; j < std::min(blocks.size(), i + kParallelBlocks); ++j) {
+      jobs.emplace_back(&blocks[j], Chunk{});
+    }
+    QtConcurrent::blockingMap(jobs, [](auto& job) { job.second = decodeBlock(*job.first); });
+    for (const auto& [block, chunk] : jobs) {
+      if (chunk.size > 0) sink(chunk.data, chunk.size);
+    }
+  }
+}
+
+std::vector<uint8_t> loadStream(const MdfFile& f, uint64_t offset) {
+  std::vector<Block> blocks;
+  collectDataBlocks(f, offset, blocks);
+  std::vector<uint8_t> stream;
+  forEachChunk(blocks, [&](const uint8_t* data, size_t size) { stream.insert(stream.end(), data, data + size); });
+  return stream;
+}
+
+struct Channel {
+  bool present = false;
+  uint8_t type = 0;
+  uint8_t data_type = 0;
+  uint8_t bit_offset = 0;
+  uint32_t byte_offset = 0;
+  uint32_t bit_count = 0;
+  uint64_t data_link = 0;  // cn_data: SD stream or VLSD channel group
+  double cc_offset = 0.0;  // Linear conversion, identity unless a CC block says otherwise
+  double cc_factor = 1.0;
+
+  uint32_t byteSize() const { return type == kChannelVlsd ? 8 : (bit_offset + bit_count + 7) / 8; }
+
+  uint64_t raw(const uint8_t* rec) const {
+    const uint32_t n = std::min<uint32_t>(byteSize(), 8);
+    const uint8_t* p = rec + byte_offset;
+    uint64_t v = 0;
+    if (data_type == kUintBE || data_type == kIntBE || data_type == kFloatBE) {
+      for (uint32_t i = 0; i < n; ++i) v = (v << 8) | p[i];
+    } else {
+      std::memcpy(&v, p, n);
+    }
+    v >>= bit_offset;
+    return bit_count < 64 ? v & ((1ULL << bit_count) - 1) : v;
+  }
+
+  double value(const uint8_t* rec) const {
+    const uint64_t v = raw(rec);
+    double phys = 0;
+    if ((data_type == kFloatLE || data_type == kFloatBE) && bit_count == 64) {
+      std::memcpy(&phys, &v, sizeof(phys));
+    } else if ((data_type == kFloatLE || data_type == kFloatBE) && bit_count == 32) {
+      const uint32_t v32 = static_cast<uint32_t>(v);
+      float f;
+      std::memcpy(&f, &v32, sizeof(f));
+      phys = f;
+    } else if ((data_type == kIntLE || data_type == kIntBE) && bit_count > 0 && bit_count < 64) {
+      const uint64_t sign = 1ULL << (bit_count - 1);
+      phys = static_cast<double>(static_cast<int64_t>((v ^ sign) - sign));
+    } else if (data_type == kIntLE || data_type == kIntBE) {
+      phys = static_cast<double>(static_cast<int64_t>(v));
+    } else {
+      phys = static_cast<double>(v);
+    }
+    return cc_offset + cc_factor * phys;
+  }
+};
+
+Channel parseChannel(const MdfFile& f, const Block& cn) {
+  Channel c;
+  c.present = true;
+  c.type = cn.field<uint8_t>(0);
+  c.data_type = cn.field<uint8_t>(2);
+  c.bit_offset = cn.field<uint8_t>(3);
+  c.byte_offset = cn.field<uint32_t>(4);
+  c.bit_count = cn.field<uint32_t>(8);
+  c.data_link = cn.link(5);
+
+  Block cc;
+  if (f.block(cn.link(4), cc) && cc.is("CC") && cc.field<uint8_t>(0) == kConversionLinear) {
+    c.cc_offset = cc.field<double>(24);
+    c.cc_factor = cc.field<double>(32);
+  }
+  return c;
+}
+
+struct CanGroup {
+  Channel time, bus, id, dlc, data_length, data_bytes;
+  std::vector<uint8_t> signal_data;  // SD stream when DataBytes is a VLSD channel stored in an SD block
+
+  // DataBytes stored in a VLSD channel group: records are matched by their offset in the group's stream
+  uint64_t vlsd_offset = 0;
+  std::unordered_map<uint64_t, std::vector<uint8_t>> vlsd_pending;  // VLSD seen before its CAN record
+  std::unordered_map<uint64_t, size_t> frames_waiting;              // CAN record seen before its VLSD
+
+  bool valid(uint32_t record_size) const {
+    auto fits = [record_size](const Channel& c) { return !c.present || c.byte_offset + c.byteSize() <= record_size; };
+    return time.present && id.present && data_bytes.present && fits(time) && fits(bus) && fits(id) && fits(dlc) &&
+           fits(data_length) && fits(data_bytes);
+  }
+};
+
+void collectFields(const MdfFile& f, uint64_t offset, CanGroup& g, int depth) {
+  Block cn;
+  for (size_t n = 0; depth < 4 && n < kMaxChainLength && f.block(offset, cn) && cn.is("CN"); ++n, offset = cn.link(0)) {
+    const QString name = f.text(cn.link(2));
+    if (cn.field<uint8_t>(0) == kChannelMaster && cn.field<uint8_t>(1) == kSyncTime) {
+      g.time = parseChannel(f, cn);
+    } else if (name.startsWith("CAN_DataFrame")) {
+      const QString field = name.section('.', -1);
+      if (field == "BusChannel") g.bus = parseChannel(f, cn);
+      else if (field == "ID") g.id = parseChannel(f, cn);
+      else if (field == "DLC") g.dlc = parseChannel(f, cn);
+      else if (field == "DataLength") g.data_length = parseChannel(f, cn);
+      else if (field == "DataBytes") g.data_bytes = parseChannel(f, cn);
+
+      if (cn.link(1)) collectFields(f, cn.link(1), g, depth + 1);
+    }
+  }
+}
+
+class DataGroupReader {
+ public:
+  DataGroupReader(const MdfFile& f, std::vector<ParsedCanFrame>& frames) : file_(f), frames_(frames) {}
+
+  void read(const Block& dg) {
+    id_size_ = dg.field<uint8_t>(0);
+    if (id_size_ != 0 && id_size_ != 1 && id_size_ != 2 && id_size_ != 4 && id_size_ != 8) return;
+    if (!readChannelGroups(dg) || groups_.empty()) return;
+
+    std::vector<Block> blocks;
+    collectDataBlocks(file_, dg.link(2), blocks);
+
+    std::vector<uint8_t> carry;  // Tail of a record that spans two data blocks
+    forEachChunk(blocks, [&](const uint8_t* data, size_t size) {
+      if (corrupt_) return;
+      if (carry.empty()) {
+        size_t consumed = consumeRecords(data, size);
+        carry.assign(data + consumed, data + size);
+      } else {
+        carry.insert(carry.end(), data, data + size);
+        size_t consumed = consumeRecords(carry.data(), carry.size());
+        carry.erase(carry.begin(), carry.begin() + consumed);
+      }
+    });
+  }
+
+ private:
+  struct RecordLayout {
+    uint32_t size = 0;            // cg_data_bytes + cg_inval_bytes
+    bool vlsd = false;            // VLSD group: u32 length followed by the bytes
+    CanGroup* can = nullptr;      // CAN_DataFrame group decoded from these records
+    CanGroup* owner = nullptr;    // CAN group whose DataBytes live in this VLSD group
+  };
+
+  bool readChannelGroups(const Block& dg) {
+    std::unordered_map<uint64_t, uint64_t> record_ids;  // CG block offset -> record id
+    uint64_t cycle_count = 0;
+
+    Block cg;
+    uint64_t offset = dg.link(1);
+    for (size_t n = 0; n < kMaxChainLength && file_.block(offset, cg) && cg.is("CG"); ++n, offset = cg.link(0)) {
+      const uint64_t record_id = cg.field<uint64_t>(0);
+      RecordLayout layout;
+      layout.vlsd = cg.field<uint16_t>(16) & kGroupVlsd;
+      layout.size = cg.field<uint32_t>(24) + cg.field<uint32_t>(28);
+      record_ids[offset] = record_id;
+
+      if (!layout.vlsd) {
+        CanGroup g;
+        collectFields(file_, cg.link(1), g, 0);
+        if (g.valid(layout.size)) {
+          layout.can = &groups_.emplace_back(std::move(g));
+          cycle_count += cg.field<uint64_t>(8);
+        }
+      }
+      layouts_[record_id] = layout;
+      if (id_size_ == 0) {
+        sorted_layout_ = &layouts_[record_id];
+        break;  // A sorted data group holds a single channel group
+      }
+    }
+
+    for (auto& g : groups_) {
+      if (g.data_bytes.type != kChannelVlsd) continue;
+      Block target;
+      if (!file_.block(g.data_bytes.data_link, target)) {
+        g.data_bytes.present = false;
+      } else if (target.is("CG")) {
+        auto it = record_ids.find(g.data_bytes.data_link);
+        if (it == record_ids.end()) return false;
+        layouts_[it->second].owner = &g;
+      } else {
+        g.signal_data = loadStream(file_, g.data_bytes.data_link);
+      }
+    }
+
+    frames_.reserve(frames_.size() + std::min<uint64_t>(cycle_count, file_.size));
+    return true;
+  }
+
+  // Decodes every complete record in [data, data + size) and returns the number of bytes consumed.
+  size_t consumeRecords(const uint8_t* data, size_t size) {
+    size_t pos = 0;
+    while (pos + id_size_ <= size) {
+      const RecordLayout* layout = sorted_layout_;
+      if (id_size_ > 0) {
+        auto it = layouts_.find(readRecordId(data + pos));
+        if (it == layouts_.end()) {
+          qWarning() << "Mf4LogStream: unknown record id, skipping rest of data group";
+          corrupt_ = true;
+          return size;
+        }
+        layout = &it->second;
+      }
+
+      const uint8_t* rec = data + pos + id_size_;
+      if (layout->vlsd) {
+        if (pos + id_size_ + 4 > size) break;
+        const uint32_t len = readLE<uint32_t>(rec);
+        if (pos + id_size_ + 4 + len > size) break;
+        if (layout->owner) handleVlsdRecord(*layout->owner, rec + 4, len);
+        pos += id_size_ + 4 + len;
+      } else {
+        if (pos + id_size_ + layout->size > size) break;
+        if (layout->can) decodeCanRecord(*layout->can, rec);
+        pos += id_size_ + layout->size;
+      }
+    }
+    return pos;
+  }
+
+  uint64_t readRecordId(const uint8_t* p) const {
+    switch (id_size_) {
+      case 1: return p[0];
+      case 2: return readLE<uint16_t>(p);
+      case 4: return readLE<uint32_t>(p);
+      default: return readLE<uint64_t>(p);
+    }
+  }
+
+  void decodeCanRecord(CanGroup& g, const uint8_t* rec) {
+    if (!g.data_bytes.present) return;
+
+    ParsedCanFrame& f = frames_.emplace_back();
+    const double t = g.time.value(rec);
+    f.rel_ns = t > 0 ? static_cast<uint64_t>(t * 1e9) : 0;
+    const uint64_t channel = g.bus.present ? g.bus.raw(rec) : 0;
+    f.bus = static_cast<uint8_t>(channel > 0 ? channel - 1 : 0);  // Bus channels are 1-based
+    f.address = g.id.raw(rec) & 0x1FFFFFFF;
+
+    size_t len = sizeof(f.data);
+    if (g.data_length.present) {
+      len = std::min<size_t>(len, g.data_length.raw(rec));
+    } else if (g.dlc.present) {
+      len = kDlcToLen[g.dlc.raw(rec) & 0xF];
+    }
+
+    if (g.data_bytes.type != kChannelVlsd) {
+      copyPayload(f, rec + g.data_bytes.byte_offset, g.data_bytes.bit_count / 8, len);
+      return;
+    }
+
+    const uint64_t offset = readLE<uint64_t>(rec + g.data_bytes.byte_offset);
+    if (!g.signal_data.empty()) {
+      if (offset + 4 <= g.signal_data.size()) {
+        const uint32_t available = readLE<uint32_t>(g.signal_data.data() + offset);
+        copyPayload(f, g.signal_data.data() + offset + 4, std::min<uint64_t>(available, g.signal_data.size() - offset - 4), len);
+      }
+    } else if (auto it = g.vlsd_pending.find(offset); it != g.vlsd_pending.end()) {
+      copyPayload(f, it->second.data(), it->second.size(), len);
+      g.vlsd_pending.erase(it);
+    } else {
+      f.size = static_cast<uint8_t>(len);  // Clamped to the payload once its VLSD record arrives
+      g.frames_waiting[offset] = frames_.size() - 1;
+    }
+  }
+
+  void handleVlsdRecord(CanGroup& g, const uint8_t* bytes, uint32_t len) {
+    const uint64_t offset = g.vlsd_offset;
+    g.vlsd_offset += 4 + len;
+
+    if (auto it = g.frames_waiting.find(offset); it != g.frames_waiting.end()) {
+      ParsedCanFrame& f = frames_[it->second];
+      copyPayload(f, bytes, len, f.size);
+      g.frames_waiting.erase(it);
+    } else {
+      g.vlsd_pending.emplace(offset, std::vector<uint8_t>(bytes, bytes + std::min<uint32_t>(len, sizeof(ParsedCanFrame::data))));
+    }
+  }
+
+  static void copyPayload(ParsedCanFrame& f, const uint8_t* bytes, size_t available, size_t len) {
+    f.size = static_cast<uint8_t>(std::min({available, len, sizeof(f.data)}));
+    std::memcpy(f.data, bytes, f.size);
+  }
+
+  const MdfFile& file_;
+  std::vector<ParsedCanFrame>& frames_;
+  uint8_t id_size_ = 0;
+  bool corrupt_ = false;
+  std::deque<CanGroup> groups_;  // deque keeps CanGroup pointers stable
+  std::unordered_map<uint64_t, RecordLayout> layouts_;
+  RecordLayout* sorted_layout_ = nullptr;
+};
+
+}  // namespace
+
+Mf4LogStream::Mf4LogStream(QObject* parent, const QStringList& file_paths) : FileStream(parent, file_paths) {
+  loadParsedFiles();
+}
+
+std::vector<ParsedCanFrame> Mf4LogStream::parseFile(const QString& file_path) {
+  QFile file(file_path);
+  if (!file.open(QIODevice::ReadOnly)) {
+    qWarning() << "Mf4LogStream: failed to open" << file_path;
+    return {};
+  }
+
+  MdfFile mdf;
+  mdf.size = file.size();
+  mdf.base = mdf.size > kIdBlockSize ? file.map(0, mdf.size) : nullptr;
+  // Finalized files start with "MDF     ", loggers that were cut off write "UnFinMF "
+  if (!mdf.base || (std::memcmp(mdf.base, "MDF ", 4) != 0 && std::memcmp(mdf.base, "UnFinMF ", 8) != 0) ||
+      readLE<uint16_t>(mdf.base + 28) < 400) {
+    qWarning() << "Mf4LogStream: not an MDF4 file" << file_path;
+    return {};
+  }
+
+  Block hd;
+  if (!mdf.block(kIdBlockSize, hd) || !hd.is("HD")) {
+    qWarning() << "Mf4LogStream: missing header block" << file_path;
+    return {};
+  }
+
+  std::vector<ParsedCanFrame> frames;
+  Block dg;
+  uint64_t offset = hd.link(0);
+  for (size_t n = 0; n < kMaxChainLength && mdf.block(offset, dg) && dg.is("DG"); ++n, offset = dg.link(0)) {
+    DataGroupReader(mdf, frames).read(dg);
+  }
+  return frames;
+}
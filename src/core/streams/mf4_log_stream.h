@@ -0,0 +1,16 @@
+#pragma once
+
+#include <QStringList>
+#include <vector>
+
+#include "file_stream.h"
+
+class Mf4LogStream : public FileStream {
+  Q_OBJECT
+
+ public:
+  Mf4LogStream(QObject* parent, const QStringList& file_paths);
+
+ protected:
+  std::vector<ParsedCanFrame> parseFile(const QString& file_path) override;
+};
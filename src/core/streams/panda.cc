@@ -11,8 +11,6 @@
 // #include "common/swaglog.h"
 #include "common/util.h"
 
-static const unsigned char dlc_to_len[] = {0U, 1U, 2U, 3U, 4U, 5U, 6U, 7U, 8U, 12U, 16U, 20U, 24U, 32U, 48U, 64U};
-
 static libusb_context* init_usb_ctx() {
   libusb_context* context = nullptr;
   int err = libusb_init(&context);
@@ -39,7 +37,10 @@ Panda::Panda(std::string serial, uint32_t bus_offset) : bus_offset(bus_offset) {
   can_reset_communications();
 }
 
-Panda::~Panda() { cleanup_usb(); }
+Panda::~Panda() {
+  stop_receive();
+  cleanup_usb();
+}
 
 bool Panda::connected() { return connected_flag; }
 
@@ -109,68 +110,95 @@ void Panda::set_can_speed_kbps(uint16_t bus, uint16_t speed) { control_write(0xd
 
 void Panda::set_data_speed_kbps(uint16_t bus, uint16_t speed) { control_write(0xf9, bus, (speed * 10)); }
 
-bool Panda::can_receive(std::vector<can_frame>& out_vec) {
-  // Check if enough space left in buffer to store RECV_SIZE data
-  assert(receive_buffer_size + RECV_SIZE <= sizeof(receive_buffer));
+void Panda::can_reset_communications() { control_write(0xc0, 0, 0); }
 
-  int recv = bulk_read(0x81, &receive_buffer[receive_buffer_size], RECV_SIZE);
-  if (!comms_healthy()) {
+bool Panda::start_receive(ReceiveCallback callback) {
+  if (!connected_flag || recv_active) {
     return false;
   }
 
-  bool ret = true;
-  if (recv > 0) {
-    receive_buffer_size += recv;
-    ret = unpack_can_buffer(receive_buffer, receive_buffer_size, out_vec);
+  receive_callback = std::move(callback);
+  recv_buffers = std::make_unique<uint8_t[]>(NUM_RECV_TRANSFERS * RECV_SIZE);
+  recv_active = true;
+  for (int i = 0; i < NUM_RECV_TRANSFERS; ++i) {
+    libusb_transfer* transfer = libusb_alloc_transfer(0);
+    if (!transfer) {
+      stop_receive();
+      return false;
+    }
+    recv_transfers.push_back(transfer);
+    libusb_fill_bulk_transfer(transfer, dev_handle, 0x81, &recv_buffers[i * RECV_SIZE], RECV_SIZE, receive_complete,
+                              this, 0);
+    int err = libusb_submit_transfer(transfer);
+    if (err != 0) {
+      handle_usb_issue(err, __func__);
+      stop_receive();
+      return false;
+    }
+    ++recv_in_flight;
   }
-  return ret;
+  return true;
 }
 
-void Panda::can_reset_communications() { control_write(0xc0, 0, 0); }
-
-bool Panda::unpack_can_buffer(uint8_t* data, uint32_t& size, std::vector<can_frame>& out_vec) {
-  int pos = 0;
-
-  while (pos <= size - sizeof(can_header)) {
-    can_header header;
-    memcpy(&header, &data[pos], sizeof(can_header));
-
-    const uint8_t data_len = dlc_to_len[header.data_len_code];
-    if (pos + sizeof(can_header) + data_len > size) {
-      // we don't have all the data for this message yet
-      break;
-    }
+void Panda::stop_receive() {
+  recv_active = false;
+  for (auto transfer : recv_transfers) {
+    libusb_cancel_transfer(transfer);
+  }
+  // libusb completes every cancelled transfer, also when the device is gone. Until then it
+  // owns the transfer and its buffer, and its callback still refers to this panda.
+  while (recv_in_flight > 0) {
+    handle_events(100);
+  }
 
-    if (calculate_checksum(&data[pos], sizeof(can_header) + data_len) != 0) {
-      // LOGE("Panda CAN checksum failed");
-      size = 0;
-      can_reset_communications();
-      return false;
-    }
+  for (auto transfer : recv_transfers) {
+    libusb_free_transfer(transfer);
+  }
+  recv_transfers.clear();
+  recv_buffers.reset();
+  receive_callback = nullptr;
+}
 
-    can_frame& canData = out_vec.emplace_back();
-    canData.address = header.addr;
-    canData.src = header.bus + bus_offset;
-    if (header.rejected) {
-      canData.src += CAN_REJECTED_BUS_OFFSET;
-    }
-    if (header.returned) {
-      canData.src += CAN_RETURNED_BUS_OFFSET;
-    }
+void Panda::handle_events(int timeout_ms) {
+  if (!ctx) return;
 
-    canData.dat.assign((char*)&data[pos + sizeof(can_header)], data_len);
+  timeval tv = {timeout_ms / 1000, (timeout_ms % 1000) * 1000};
+  int err = libusb_handle_events_timeout_completed(ctx, &tv, nullptr);
+  if (err != 0) handle_usb_issue(err, __func__);
+}
 
-    pos += sizeof(can_header) + data_len;
+void LIBUSB_CALL Panda::receive_complete(libusb_transfer* transfer) {
+  Panda* panda = static_cast<Panda*>(transfer->user_data);
+  switch (transfer->status) {
+    case LIBUSB_TRANSFER_COMPLETED:
+      if (transfer->actual_length > 0 && panda->recv_active) {
+        panda->receive_callback(transfer->buffer, transfer->actual_length);
+      }
+      break;
+    case LIBUSB_TRANSFER_OVERFLOW:
+      panda->comms_healthy_flag = false;
+      // LOGE_100("overflow got 0x%x", transfer->actual_length);
+      break;
+    case LIBUSB_TRANSFER_NO_DEVICE:
+      panda->handle_usb_issue(LIBUSB_ERROR_NO_DEVICE, __func__);
+      break;
+    case LIBUSB_TRANSFER_CANCELLED:
+      break;
+    default:
+      panda->handle_usb_issue(LIBUSB_ERROR_IO, __func__);
+      break;
   }
 
-  // move the overflowing data to the beginning of the buffer for the next round
-  memmove(data, &data[pos], size - pos);
-  size -= pos;
-
-  return true;
+  // Resubmit right away to keep the same number of transfers queued on the endpoint
+  if (panda->recv_active && panda->connected_flag && transfer->status != LIBUSB_TRANSFER_CANCELLED) {
+    int err = libusb_submit_transfer(transfer);
+    if (err == 0) return;
+    panda->handle_usb_issue(err, __func__);
+  }
+  --panda->recv_in_flight;
 }
 
-uint8_t Panda::calculate_checksum(uint8_t* data, uint32_t len) {
+uint8_t Panda::calculate_checksum(const uint8_t* data, uint32_t len) {
   uint8_t checksum = 0U;
   for (uint32_t i = 0U; i < len; i++) {
     checksum ^= data[i];
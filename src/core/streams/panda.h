@@ -4,6 +4,7 @@
 
 #include <atomic>
 #include <cstdint>
+#include <cstring>
 #include <ctime>
 #include <functional>
 #include <list>
@@ -21,6 +22,7 @@
 #define USB_TX_SOFT_LIMIT (0x100U)
 #define USBPACKET_MAX_SIZE (0x40)
 #define RECV_SIZE (0x4000U)
+#define NUM_RECV_TRANSFERS 8
 #define TIMEOUT 0
 
 #define CAN_REJECTED_BUS_OFFSET 0xC0U
@@ -39,21 +41,33 @@ struct __attribute__((packed)) can_header {
   uint8_t checksum : 8;
 };
 
-struct can_frame {
-  long address;
-  std::string dat;
-  long src;
+// Receive side of a panda connection. Panda implements it over USB; a stand-in that
+// replays recorded USB buffers can implement it to drive PandaStream without hardware.
+class PandaTransport {
+ public:
+  // Called with the bytes of each completed bulk IN transfer, in the order they were received.
+  using ReceiveCallback = std::function<void(const uint8_t* data, uint32_t len)>;
+
+  virtual ~PandaTransport() = default;
+  virtual bool connected() = 0;
+  virtual bool start_receive(ReceiveCallback callback) = 0;
+  virtual void stop_receive() = 0;
+  // Waits up to timeout_ms for completed transfers and runs the receive callback for each
+  // of them on the calling thread. The callback must not issue transfers itself.
+  virtual void handle_events(int timeout_ms) = 0;
+  virtual void send_heartbeat(bool engaged) = 0;
+  virtual void can_reset_communications() = 0;
 };
 
-class Panda {
+class Panda : public PandaTransport {
  public:
   Panda(std::string serial = "", uint32_t bus_offset = 0);
-  ~Panda();
+  ~Panda() override;
 
   cereal::PandaState::PandaType hw_type = cereal::PandaState::PandaType::UNKNOWN;
   const uint32_t bus_offset;
 
-  bool connected();
+  bool connected() override;
   bool comms_healthy();
   std::string hw_serial();
 
@@ -63,11 +77,23 @@ class Panda {
   // Panda functionality
   cereal::PandaState::PandaType get_hw_type();
   void set_safety_model(cereal::CarParams::SafetyModel safety_model, uint16_t safety_param = 0U);
-  void send_heartbeat(bool engaged);
+  void send_heartbeat(bool engaged) override;
   void set_can_speed_kbps(uint16_t bus, uint16_t speed);
   void set_data_speed_kbps(uint16_t bus, uint16_t speed);
-  bool can_receive(std::vector<can_frame>& out_vec);
-  void can_reset_communications();
+  void can_reset_communications() override;
+
+  // Keeps NUM_RECV_TRANSFERS asynchronous bulk reads in flight so the device never waits
+  // for the host to ask for the next buffer.
+  bool start_receive(ReceiveCallback callback) override;
+  void stop_receive() override;
+  void handle_events(int timeout_ms) override;
+
+  // Unpacks every complete frame in `data` and calls sink(src, address, dat, len) for it.
+  // `dat` points into `data` and is only valid for the duration of the call. The bytes of a
+  // trailing partial frame are moved to the front and `size` is updated. Returns false on a
+  // checksum failure, after discarding the buffer.
+  template <typename Sink>
+  static bool unpack_can_buffer(uint8_t* data, uint32_t& size, uint32_t src_offset, Sink&& sink);
 
  private:
   // USB connection members
@@ -77,9 +103,12 @@ class Panda {
   std::atomic<bool> connected_flag = true;
   std::atomic<bool> comms_healthy_flag = true;
 
-  // CAN buffer members
-  uint8_t receive_buffer[RECV_SIZE + sizeof(can_header) + 64];
-  uint32_t receive_buffer_size = 0;
+  // Asynchronous receive members
+  ReceiveCallback receive_callback;
+  std::unique_ptr<uint8_t[]> recv_buffers;
+  std::vector<libusb_transfer*> recv_transfers;
+  int recv_in_flight = 0;
+  bool recv_active = false;
 
   // Internal methods
   bool init_usb_connection(const std::string& serial);
@@ -90,6 +119,46 @@ class Panda {
                    unsigned int timeout = TIMEOUT);
   int bulk_write(unsigned char endpoint, unsigned char* data, int length, unsigned int timeout = TIMEOUT);
   int bulk_read(unsigned char endpoint, unsigned char* data, int length, unsigned int timeout = TIMEOUT);
-  bool unpack_can_buffer(uint8_t* data, uint32_t& size, std::vector<can_frame>& out_vec);
-  uint8_t calculate_checksum(uint8_t* data, uint32_t len);
+  static void LIBUSB_CALL receive_complete(libusb_transfer* transfer);
+  static uint8_t calculate_checksum(const uint8_t* data, uint32_t len);
+
+  static constexpr uint8_t dlc_to_len[] = {0U, 1U, 2U, 3U, 4U, 5U, 6U, 7U, 8U, 12U, 16U, 20U, 24U, 32U, 48U, 64U};
 };
+
+template <typename Sink>
+bool Panda::unpack_can_buffer(uint8_t* data, uint32_t& size, uint32_t src_offset, Sink&& sink) {
+  uint32_t pos = 0;
+
+  while (pos + sizeof(can_header) <= size) {
+    can_header header;
+    memcpy(&header, &data[pos], sizeof(can_header));
+
+    const uint8_t data_len = dlc_to_len[header.data_len_code];
+    if (pos + sizeof(can_header) + data_len > size) {
+      // we don't have all the data for this message yet
+      break;
+    }
+
+    if (calculate_checksum(&data[pos], sizeof(can_header) + data_len) != 0) {
+      size = 0;
+      return false;
+    }
+
+    uint8_t src = header.bus + src_offset;
+    if (header.rejected) {
+      src += CAN_REJECTED_BUS_OFFSET;
+    }
+    if (header.returned) {
+      src += CAN_RETURNED_BUS_OFFSET;
+    }
+    sink(src, static_cast<uint32_t>(header.addr), &data[pos + sizeof(can_header)], data_len);
+
+    pos += sizeof(can_header) + data_len;
+  }
+
+  // move the overflowing data to the beginning of the buffer for the next round
+  memmove(data, &data[pos], size - pos);
+  size -= pos;
+
+  return true;
+}
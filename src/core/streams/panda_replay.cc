@@ -0,0 +1,45 @@
+#include "panda_replay.h"
+
+#include <QDebug>
+#include <QFile>
+#include <cstring>
+
+PandaReplay::PandaReplay(std::vector<QByteArray> transfers) : transfers_(std::move(transfers)) {}
+
+std::vector<QByteArray> PandaReplay::load(const QString& path) {
+  QFile file(path);
+  if (!file.open(QIODevice::ReadOnly)) {
+    qWarning() << "PandaReplay: failed to open" << path;
+    return {};
+  }
+
+  const QByteArray data = file.readAll();
+  std::vector<QByteArray> transfers;
+  qsizetype pos = 0;
+  while (pos + (qsizetype)sizeof(uint32_t) <= data.size()) {
+    uint32_t len;
+    std::memcpy(&len, data.constData() + pos, sizeof(len));
+    pos += sizeof(len);
+    if (len > data.size() - pos) break;
+
+    transfers.push_back(data.mid(pos, len));
+    pos += len;
+  }
+  if (pos != data.size()) {
+    qWarning() << "PandaReplay: truncated recording" << path;
+    return {};
+  }
+  return transfers;
+}
+
+bool PandaReplay::start_receive(ReceiveCallback callback) {
+  callback_ = std::move(callback);
+  return true;
+}
+
+void PandaReplay::handle_events(int timeout_ms) {
+  if (!callback_ || next_ >= transfers_.size()) return;
+
+  const QByteArray& transfer = transfers_[next_++];
+  callback_(reinterpret_cast<const uint8_t*>(transfer.constData()), transfer.size());
+}
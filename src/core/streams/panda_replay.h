@@ -0,0 +1,36 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <atomic>
+#include <vector>
+
+#include "panda.h"
+
+// Replays bulk IN transfers recorded from a panda, so PandaStream runs without hardware.
+// A recording is a sequence of transfers, each a little-endian uint32 length followed by the bytes
+// of the transfer. One transfer completes per handle_events() call, and the transport reports
+// itself disconnected once all of them were delivered.
+class PandaReplay : public PandaTransport {
+ public:
+  explicit PandaReplay(std::vector<QByteArray> transfers);
+  // Empty if the file can't be read or is truncated
+  static std::vector<QByteArray> load(const QString& path);
+
+  bool connected() override { return next_ < transfers_.size(); }
+  bool start_receive(ReceiveCallback callback) override;
+  void stop_receive() override { callback_ = nullptr; }
+  void handle_events(int timeout_ms) override;
+  void send_heartbeat(bool engaged) override { ++heartbeats_; }
+  void can_reset_communications() override { ++resets_; }
+
+  int heartbeats() const { return heartbeats_; }
+  int resets() const { return resets_; }
+
+ private:
+  const std::vector<QByteArray> transfers_;
+  size_t next_ = 0;
+  ReceiveCallback callback_;
+  std::atomic<int> heartbeats_{0};
+  std::atomic<int> resets_{0};
+};
@@ -3,6 +3,11 @@
 #include <QDebug>
 #include <QThread>
 #include <QTimer>
+#include <cstring>
+
+#include "common/timing.h"
+
+static constexpr uint64_t HEARTBEAT_INTERVAL_NS = 500'000'000;
 
 PandaStream::PandaStream(QObject* parent, PandaStreamConfig config_) : LiveStream(parent), config(config_) {
   if (!connect()) {
@@ -10,7 +15,11 @@ PandaStream::PandaStream(QObject* parent, PandaStreamConfig config_) : LiveStrea
   }
 }
 
+PandaStream::PandaStream(QObject* parent, std::unique_ptr<PandaTransport> transport_)
+    : LiveStream(parent), transport(std::move(transport_)), reconnect(false) {}
+
 bool PandaStream::connect() {
+  std::unique_ptr<Panda> panda;
   try {
     qDebug() << "Connecting to panda " << config.serial;
     panda.reset(new Panda(config.serial.toStdString()));
@@ -35,40 +44,75 @@ bool PandaStream::connect() {
       }
     }
   }
+  transport = std::move(panda);
   return true;
 }
 
 void PandaStream::streamThread() {
-  std::vector<can_frame> raw_can_data;
+  auto on_receive = [this](const uint8_t* data, uint32_t len) { receive(data, len); };
+  bool receiving = transport->start_receive(on_receive);
+  uint64_t next_heartbeat_ns = 0;
 
   while (!QThread::currentThread()->isInterruptionRequested()) {
-    QThread::msleep(1);
+    if (!transport->connected()) {
+      if (!reconnect) break;
 
-    if (!panda->connected()) {
       qDebug() << "Connection to panda lost. Attempting reconnect.";
       if (!connect()) {
         QThread::msleep(1000);
         continue;
       }
+      recv_size = 0;
+      receiving = false;
+    }
+
+    if (!receiving) {
+      receiving = transport->start_receive(on_receive);
+      if (!receiving) {
+        qDebug() << "failed to receive";
+        QThread::msleep(100);
+        continue;
+      }
     }
 
-    raw_can_data.clear();
-    if (!panda->can_receive(raw_can_data)) {
-      qDebug() << "failed to receive";
-      continue;
+    // Completed transfers are dispatched to receive() from here
+    transport->handle_events(50);
+
+    if (reset_pending) {
+      reset_pending = false;
+      transport->can_reset_communications();
     }
 
-    MessageBuilder msg;
-    auto evt = msg.initEvent();
-    auto canData = evt.initCan(raw_can_data.size());
-    for (uint i = 0; i < raw_can_data.size(); i++) {
-      canData[i].setAddress(raw_can_data[i].address);
-      canData[i].setDat(kj::arrayPtr((uint8_t*)raw_can_data[i].dat.data(), raw_can_data[i].dat.size()));
-      canData[i].setSrc(raw_can_data[i].src);
+    const uint64_t now = nanos_since_boot();
+    if (now >= next_heartbeat_ns) {
+      transport->send_heartbeat(false);
+      next_heartbeat_ns = now + HEARTBEAT_INTERVAL_NS;
     }
+  }
 
-    handleEvent(capnp::messageToFlatArray(msg));
+  transport->stop_receive();
+}
+
+// Called from the stream thread for each completed transfer. Frames are unpacked straight
+// into the event arena and all frames of one transfer share the time it completed.
+void PandaStream::receive(const uint8_t* data, uint32_t len) {
+  if (recv_buffer.size() < recv_size + len) {
+    recv_buffer.resize(recv_size + len);
+  }
+  memcpy(&recv_buffer[recv_size], data, len);
+  recv_size += len;
 
-    panda->send_heartbeat(false);
+  recv_events.clear();
+  const uint64_t mono_ns = nanos_since_boot();
+  bool ok = Panda::unpack_can_buffer(recv_buffer.data(), recv_size, 0,
+                                     [&](uint8_t src, uint32_t address, const uint8_t* dat, uint8_t size) {
+                                       recv_events.push_back(newEvent(mono_ns, src, address, dat, size));
+                                     });
+  // Frames unpacked before a checksum failure are still valid
+  handleEvents(recv_events);
+  if (!ok) {
+    // Transfers can't be issued from within a completion callback, reset from the loop instead
+    qDebug() << "Panda CAN checksum failed";
+    reset_pending = true;
   }
 }
@@ -24,13 +24,23 @@ class PandaStream : public LiveStream {
   Q_OBJECT
  public:
   PandaStream(QObject* parent, PandaStreamConfig config_ = {});
+  // Streams from the given transport instead of a USB panda, e.g. one replaying recorded buffers.
+  PandaStream(QObject* parent, std::unique_ptr<PandaTransport> transport_);
   ~PandaStream() { stop(); }
   inline QString routeName() const override { return QString("Panda: %1").arg(config.serial); }
 
  protected:
   bool connect();
   void streamThread() override;
+  void receive(const uint8_t* data, uint32_t len);
 
-  std::unique_ptr<Panda> panda;
+  std::unique_ptr<PandaTransport> transport;
   PandaStreamConfig config = {};
+  bool reconnect = true;  // Only USB pandas are reconnected
+
+  // Stream thread state. Frames may straddle two transfers, so the tail is carried over.
+  std::vector<uint8_t> recv_buffer;
+  uint32_t recv_size = 0;
+  std::vector<const CanEvent*> recv_events;
+  bool reset_pending = false;
 };
@@ -0,0 +1,270 @@
+#include "pcap_log_stream.h"
+
+#include <sys/mman.h>
+
+#include <QDebug>
+#include <QFile>
+#include <QtEndian>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+// Reads libpcap (.pcap) and pcapng captures of SocketCAN interfaces, e.g. from
+// `tcpdump -i can0 -w capture.pcap` or Wireshark. Supported link types:
+//   LINKTYPE_CAN_SOCKETCAN (227)  can_id is big-endian
+//   LINKTYPE_LINUX_SLL (113)      cooked header, used by older tcpdump for "-i any"
+//   LINKTYPE_LINUX_SLL2 (276)     cooked header with the capturing interface index
+// The file is memory-mapped and walked in a single pass without text conversion.
+
+namespace {
+
+constexpr uint32_t kPcapMagicUs = 0xa1b2c3d4;
+constexpr uint32_t kPcapMagicNs = 0xa1b23c4d;
+constexpr size_t kPcapHeaderSize = 24;
+constexpr size_t kPcapRecordHeaderSize = 16;
+
+constexpr uint32_t kPcapngSectionHeader = 0x0a0d0d0a;
+constexpr uint32_t kPcapngInterfaceDesc = 1;
+constexpr uint32_t kPcapngPacket = 2;  // Obsolete, still written by some tools
+constexpr uint32_t kPcapngEnhancedPacket = 6;
+constexpr uint32_t kPcapngByteOrderMagic = 0x1a2b3c4d;
+constexpr uint16_t kOptIfName = 2;
+constexpr uint16_t kOptIfTsresol = 9;
+constexpr uint16_t kOptIfTsoffset = 14;
+
+constexpr uint16_t kLinkTypeSll = 113;
+constexpr uint16_t kLinkTypeSocketCan = 227;
+constexpr uint16_t kLinkTypeSll2 = 276;
+constexpr uint16_t kEthPCan = 0x000c;
+constexpr uint16_t kEthPCanFd = 0x000d;
+constexpr size_t kSllHeaderSize = 16;
+constexpr size_t kSll2HeaderSize = 20;
+
+// struct canfd_frame header: can_id, len, flags, res0, res1/len8_dlc
+constexpr size_t kCanHeaderSize = 8;
+constexpr uint32_t kCanEffFlag = 0x80000000;
+constexpr uint32_t kCanRtrFlag = 0x40000000;
+constexpr uint32_t kCanErrFlag = 0x20000000;
+constexpr uint32_t kCanEffMask = 0x1fffffff;
+constexpr uint32_t kCanSffMask = 0x000007ff;
+
+// A standard-frame id never uses bits 11..28; used to detect the byte order of cooked captures.
+inline bool plausibleCanId(uint32_t id) { return (id & kCanEffFlag) || (id & (kCanEffMask & ~kCanSffMask)) == 0; }
+
+// Converts a pcapng timestamp in if_tsresol units (10^-n, or 2^-n if the high bit is set) to ns.
+uint64_t toNanos(uint64_t ts, uint8_t tsresol) {
+  const uint8_t exp = tsresol & 0x7f;
+  if (tsresol & 0x80) {
+    return static_cast<uint64_t>((static_cast<unsigned __int128>(ts) * 1'000'000'000ULL) >> exp);
+  }
+  uint64_t scale = 1;
+  for (int i = 0; i < std::abs(9 - exp); ++i) scale *= 10;
+  return exp <= 9 ? ts * scale : ts / scale;
+}
+
+}  // namespace
+
+struct PcapLogStream::Interface {
+  uint16_t link_type = 0;
+  QString name;
+  int bus = -1;        // Assigned on the first CAN frame so non-CAN interfaces don't consume bus numbers
+  uint8_t tsresol = 6;  // pcapng default: microseconds
+  int64_t tsoffset_s = 0;
+  int8_t cooked_id_order = 0;      // SLL/SLL2 can_id byte order: 0 unknown, 1 big-endian, -1 little-endian
+  QHash<uint32_t, uint8_t> ifindex_bus;  // SLL2 "any" captures carry the real interface index per packet
+};
+
+PcapLogStream::PcapLogStream(QObject* parent, const QStringList& file_paths) : FileStream(parent, file_paths) {
+  loadParsedFiles();
+}
+
+std::vector<ParsedCanFrame> PcapLogStream::parseFile(const QString& file_path) {
+  QFile file(file_path);
+  if (!file.open(QIODevice::ReadOnly)) {
+    qWarning() << "PcapLogStream: failed to open" << file_path;
+    return {};
+  }
+
+  const size_t size = file.size();
+  uint8_t* data = size >= kPcapHeaderSize ? file.map(0, size) : nullptr;
+  if (!data) {
+    qWarning() << "PcapLogStream: failed to map" << file_path;
+    return {};
+  }
+  madvise(data, size, MADV_SEQUENTIAL);
+
+  std::vector<ParsedCanFrame> frames;
+  frames.reserve(size / 64);
+
+  const uint32_t magic = qFromLittleEndian<quint32>(data);
+  if (magic == kPcapngSectionHeader) {
+    parsePcapng(data, size, frames);
+  } else if (magic == kPcapMagicUs || magic == kPcapMagicNs || magic == qbswap(kPcapMagicUs) ||
+             magic == qbswap(kPcapMagicNs)) {
+    parsePcap(data, size, frames);
+  } else {
+    qWarning() << "PcapLogStream: not a pcap or pcapng file" << file_path;
+    return {};
+  }
+
+  // Normalize absolute capture time to file-relative nanoseconds
+  if (!frames.empty()) {
+    auto t0 = std::min_element(frames.begin(), frames.end(), [](auto& a, auto& b) { return a.rel_ns < b.rel_ns; });
+    const uint64_t t0_ns = t0->rel_ns;
+    for (auto& f : frames) f.rel_ns -= t0_ns;
+  }
+  return frames;
+}
+
+void PcapLogStream::parsePcap(const uint8_t* data, size_t size, std::vector<ParsedCanFrame>& frames) {
+  const uint32_t magic = qFromLittleEndian<quint32>(data);
+  const bool big_endian = magic == qbswap(kPcapMagicUs) || magic == qbswap(kPcapMagicNs);
+  const uint64_t frac_to_ns = (magic == kPcapMagicNs || magic == qbswap(kPcapMagicNs)) ? 1 : 1000;
+  auto u32 = [big_endian](const uint8_t* p) -> uint32_t {
+    return big_endian ? qFromBigEndian<quint32>(p) : qFromLittleEndian<quint32>(p);
+  };
+
+  Interface iface;  // Classic pcap has a single, unnamed interface
+  iface.link_type = u32(data + 20) & 0xffff;
+
+  size_t pos = kPcapHeaderSize;
+  while (size - pos >= kPcapRecordHeaderSize) {
+    const uint8_t* rec = data + pos;
+    const uint32_t incl_len = u32(rec + 8);
+    if (incl_len > size - pos - kPcapRecordHeaderSize) break;  // Truncated capture
+
+    ParsedCanFrame& f = frames.emplace_back();
+    if (decodePacket(iface, rec + kPcapRecordHeaderSize, incl_len, f)) {
+      f.rel_ns = u32(rec) * 1'000'000'000ULL + u32(rec + 4) * frac_to_ns;
+    } else {
+      frames.pop_back();
+    }
+    pos += kPcapRecordHeaderSize + incl_len;
+  }
+}
+
+void PcapLogStream::parsePcapng(const uint8_t* data, size_t size, std::vector<ParsedCanFrame>& frames) {
+  std::vector<Interface> interfaces;
+  bool big_endian = false;
+  auto u16 = [&](const uint8_t* p) -> uint16_t {
+    return big_endian ? qFromBigEndian<quint16>(p) : qFromLittleEndian<quint16>(p);
+  };
+  auto u32 = [&](const uint8_t* p) -> uint32_t {
+    return big_endian ? qFromBigEndian<quint32>(p) : qFromLittleEndian<quint32>(p);
+  };
+  auto u64 = [&](const uint8_t* p) -> uint64_t {
+    return big_endian ? qFromBigEndian<quint64>(p) : qFromLittleEndian<quint64>(p);
+  };
+
+  size_t pos = 0;
+  while (size - pos >= 12) {
+    const uint8_t* block = data + pos;
+
+    // Each section header sets the byte order of the blocks that follow it
+    if (qFromLittleEndian<quint32>(block) == kPcapngSectionHeader) {
+      const uint32_t bom = qFromLittleEndian<quint32>(block + 8);
+      if (bom != kPcapngByteOrderMagic && bom != qbswap(kPcapngByteOrderMagic)) break;
+      big_endian = bom != kPcapngByteOrderMagic;
+      interfaces.clear();  // Interface ids are scoped to their section
+    }
+
+    const uint32_t type = u32(block);
+    const uint32_t total_len = u32(block + 4);
+    if (total_len < 12 || total_len % 4 != 0 || total_len > size - pos) break;
+    const uint8_t* block_end = block + total_len - 4;
+
+    if (type == kPcapngInterfaceDesc && total_len >= 20) {
+      Interface& iface = interfaces.emplace_back();
+      iface.link_type = u16(block + 8);
+      iface.name = QString("if%1").arg(interfaces.size() - 1);
+
+      for (const uint8_t* opt = block + 16; block_end - opt >= 4;) {
+        const uint16_t code = u16(opt);
+        const uint16_t len = u16(opt + 2);
+        if (code == 0 || len > block_end - opt - 4) break;
+        if (code == kOptIfName) {
+          const char* s = reinterpret_cast<const char*>(opt + 4);
+          iface.name = QString::fromUtf8(s, strnlen(s, len));
+        } else if (code == kOptIfTsresol && len >= 1) {
+          iface.tsresol = opt[4];
+        } else if (code == kOptIfTsoffset && len >= 8) {
+          iface.tsoffset_s = static_cast<int64_t>(u64(opt + 4));
+        }
+        opt += 4 + ((len + 3) & ~3u);
+      }
+    } else if ((type == kPcapngEnhancedPacket || type == kPcapngPacket) && total_len >= 32) {
+      const uint32_t if_id = type == kPcapngEnhancedPacket ? u32(block + 8) : u16(block + 8);
+      const uint32_t cap_len = u32(block + 20);
+      if (if_id < interfaces.size() && cap_len <= static_cast<size_t>(block_end - block - 28)) {
+        Interface& iface = interfaces[if_id];
+        ParsedCanFrame& f = frames.emplace_back();
+        if (decodePacket(iface, block + 28, cap_len, f)) {
+          const uint64_t ts = (static_cast<uint64_t>(u32(block + 12)) << 32) | u32(block + 16);
+          f.rel_ns = toNanos(ts, iface.tsresol) + iface.tsoffset_s * 1'000'000'000LL;
+        } else {
+          frames.pop_back();
+        }
+      }
+    }
+    pos += total_len;
+  }
+}
+
+bool PcapLogStream::decodePacket(Interface& iface, const uint8_t* pkt, size_t len, ParsedCanFrame& f) {
+  bool cooked = true;
+  if (iface.link_type == kLinkTypeSocketCan) {
+    cooked = false;
+  } else if (iface.link_type == kLinkTypeSll && len >= kSllHeaderSize) {
+    const uint16_t protocol = qFromBigEndian<quint16>(pkt + 14);
+    if (protocol != kEthPCan && protocol != kEthPCanFd) return false;
+    pkt += kSllHeaderSize;
+    len -= kSllHeaderSize;
+  } else if (iface.link_type == kLinkTypeSll2 && len >= kSll2HeaderSize) {
+    const uint16_t protocol = qFromBigEndian<quint16>(pkt);
+    if (protocol != kEthPCan && protocol != kEthPCanFd) return false;
+    const uint32_t ifindex = qFromBigEndian<quint32>(pkt + 4);
+    if (!iface.ifindex_bus.contains(ifindex)) {
+      iface.ifindex_bus.insert(ifindex, busForInterface(QString("ifindex%1").arg(ifindex)));
+    }
+    f.bus = iface.ifindex_bus.value(ifindex);
+    pkt += kSll2HeaderSize;
+    len -= kSll2HeaderSize;
+  } else {
+    return false;
+  }
+  if (len < kCanHeaderSize) return false;
+
+  // DLT_CAN_SOCKETCAN is always network order. Cooked captures have been written in both
+  // orders by different libpcap versions, so settle it per interface from the first
+  // frame whose id is only plausible one way round.
+  uint32_t can_id = qFromBigEndian<quint32>(pkt);
+  if (cooked) {
+    const uint32_t le_id = qFromLittleEndian<quint32>(pkt);
+    if (iface.cooked_id_order == 0 && plausibleCanId(can_id) != plausibleCanId(le_id)) {
+      iface.cooked_id_order = plausibleCanId(can_id) ? 1 : -1;
+    }
+    if (iface.cooked_id_order < 0) can_id = le_id;
+  }
+
+  // Payload length above 64 also rejects CAN XL frames, whose header differs
+  const uint8_t payload_len = pkt[4];
+  if ((can_id & (kCanRtrFlag | kCanErrFlag)) || payload_len > sizeof(f.data)) return false;
+
+  if (iface.link_type != kLinkTypeSll2) {
+    if (iface.bus < 0) iface.bus = busForInterface(iface.name);
+    f.bus = static_cast<uint8_t>(iface.bus);
+  }
+  f.address = can_id & ((can_id & kCanEffFlag) ? kCanEffMask : kCanSffMask);
+  f.size = static_cast<uint8_t>(std::min<size_t>(payload_len, len - kCanHeaderSize));
+  std::memcpy(f.data, pkt + kCanHeaderSize, f.size);
+  return true;
+}
+
+uint8_t PcapLogStream::busForInterface(const QString& name) {
+  auto it = iface_map_.find(name);
+  if (it != iface_map_.end()) return it.value();
+
+  const uint8_t bus = static_cast<uint8_t>(iface_map_.size());
+  iface_map_.insert(name, bus);
+  return bus;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <QHash>
+#include <QStringList>
+#include <vector>
+
+#include "file_stream.h"
+
+class PcapLogStream : public FileStream {
+  Q_OBJECT
+
+ public:
+  PcapLogStream(QObject* parent, const QStringList& file_paths);
+
+ protected:
+  std::vector<ParsedCanFrame> parseFile(const QString& file_path) override;
+
+ private:
+  struct Interface;
+
+  void parsePcap(const uint8_t* data, size_t size, std::vector<ParsedCanFrame>& frames);
+  void parsePcapng(const uint8_t* data, size_t size, std::vector<ParsedCanFrame>& frames);
+  bool decodePacket(Interface& iface, const uint8_t* pkt, size_t len, ParsedCanFrame& f);
+  uint8_t busForInterface(const QString& name);
+
+  // Interface-to-bus map shared across files so the same interface always
+  // gets the same bus number across a multi-file session.
+  QHash<QString, uint8_t> iface_map_;
+};
@@ -2,10 +2,19 @@
 
 #include <QMessageBox>
 #include <QTimer>
+#include <QtConcurrent>
 
 #include "common/timing.h"
 #include "common/util.h"
 #include "modules/settings/settings.h"
+#include "utils/trace.h"
+
+static constexpr size_t SEGMENT_BUFFER_CHUNK_SIZE = 1024 * 1024;  // 1MB
+
+struct DecodedSegment {
+  std::unique_ptr<MonotonicBuffer> buffer;
+  std::vector<const CanEvent*> events;
+};
 
 ReplayStream::ReplayStream(QObject* parent) : AbstractStream(parent) {
   unsetenv("ZMQ");
@@ -25,30 +34,65 @@ ReplayStream::ReplayStream(QObject* parent) : AbstractStream(parent) {
       ui_update_timer->setInterval(1000 / settings.fps);
     }
   });
-  connect(ui_update_timer, &QTimer::timeout, this, &ReplayStream::commitSnapshots);
+  connect(ui_update_timer, &QTimer::timeout, this, &ReplayStream::updatePlayback);
+  connect(this, &AbstractStream::seeking, this, [this](double sec) {
+    seek_in_progress = true;
+    if (segment_prefetcher) segment_prefetcher->seeked(sec);
+  });
+  connect(this, &AbstractStream::seekedTo, this, [this](double sec) {
+    // updateSnapshotsTo() has rebuilt the state up to sec, continue playback from there
+    cursor_ns = toMonoNs(sec);
+    playback_ns = cursor_ns;
+    seek_in_progress = false;
+  });
 
   ui_update_timer->start();
 }
 
+ReplayStream::~ReplayStream() {
+  segment_prefetcher.reset();
+  // Stop the loader first so no new decode tasks are started while waiting
+  replay.reset();
+  std::lock_guard lk(decode_mutex);
+  for (auto& task : decode_tasks) {
+    task.waitForFinished();
+  }
+}
+
+// Called from the replay thread whenever segments are loaded. Each new segment is decoded by its
+// own task into its own arena; only the splice into the event lists runs on the GUI thread.
 void ReplayStream::mergeSegments() {
   auto event_data = replay->getEventData();
+
+  std::lock_guard lk(decode_mutex);
+  std::erase_if(decode_tasks, [](const QFuture<void>& task) { return task.isFinished(); });
   for (const auto& [n, seg] : event_data->segments) {
-    if (!processed_segments.count(n)) {
-      processed_segments.insert(n);
+    if (!processed_segments.insert(n).second) continue;
 
-      std::vector<const CanEvent*> new_events;
-      new_events.reserve(seg->log->events.size());
+    // Capturing event_data keeps the segment's log alive until it has been decoded
+    decode_tasks.push_back(QtConcurrent::run([this, event_data, seg = seg]() {
+      TRACE_SCOPE("decodeSegment");
+      auto decoded = std::make_shared<DecodedSegment>();
+      decoded->buffer = std::make_unique<MonotonicBuffer>(SEGMENT_BUFFER_CHUNK_SIZE);
+      decoded->events.reserve(seg->log->events.size());
       for (const Event& e : seg->log->events) {
         if (e.which == cereal::Event::Which::CAN) {
           capnp::FlatArrayMessageReader reader(e.data);
           auto event = reader.getRoot<cereal::Event>();
           for (const auto& c : event.getCan()) {
-            new_events.push_back(newEvent(e.mono_time, c));
+            decoded->events.push_back(newEvent(*decoded->buffer, e.mono_time, c));
           }
         }
       }
-      mergeEvents(new_events);
-    }
+
+      QMetaObject::invokeMethod(
+          this,
+          [this, decoded]() {
+            adoptEventBuffer(std::move(decoded->buffer));
+            mergeEvents(decoded->events);
+          },
+          Qt::QueuedConnection);
+    }));
   }
 }
 
@@ -61,6 +105,7 @@ bool ReplayStream::loadRoute(const QString& route, const QString& data_dir, uint
       .auto_source = auto_source,
       .allow = {"can", "roadEncodeIdx", "driverEncodeIdx", "wideRoadEncodeIdx", "carParams"},
   };
+  segment_prefetcher.reset();
   replay.reset(new Replay(cfg));
   replay->installEventFilter([this](const Event* event) { return eventFilter(event); });
 
@@ -71,12 +116,17 @@ bool ReplayStream::loadRoute(const QString& route, const QString& data_dir, uint
     waitForSeekFinished();
   };
   replay->onQLogLoaded = [this](std::shared_ptr<LogReader> qlog) { emit qLogLoaded(qlog); };
-  replay->onSegmentsMerged = [this]() {
-    QMetaObject::invokeMethod(this, &ReplayStream::mergeSegments, Qt::BlockingQueuedConnection);
-  };
+  replay->onSegmentsMerged = [this]() { mergeSegments(); };
 
   bool success = replay->load();
-  if (!success) {
+  if (success) {
+    std::map<int, std::string> log_urls;
+    for (const auto& [n, seg] : replay->route().segments()) {
+      log_urls[n] = seg.rlog.empty() ? seg.qlog : seg.rlog;
+    }
+    segment_prefetcher = std::make_unique<SegmentPrefetcher>(
+        std::move(log_urls), [r = replay.get()](int n) { return r->getEventData()->isSegmentLoaded(n); });
+  } else {
     if (replay->lastRouteError() == RouteLoadError::Unauthorized) {
       auto auth_content = util::read_file(util::getenv("HOME") + "/.comma/auth.json");
       QString message;
@@ -107,20 +157,46 @@ bool ReplayStream::loadRoute(const QString& route, const QString& data_dir, uint
   return success;
 }
 
+// Called from the replay thread. Only records how far playback has got; the frames themselves
+// are read from the merged timeline in updatePlayback().
 bool ReplayStream::eventFilter(const Event* event) {
   if (event->which == cereal::Event::Which::CAN) {
-    capnp::FlatArrayMessageReader reader(event->data);
-    auto e = reader.getRoot<cereal::Event>();
-    for (const auto& c : e.getCan()) {
-      MessageId id(c.getSrc(), c.getAddress());
-      const auto dat = c.getDat();
-      processNewMessage(id, event->mono_time, (const uint8_t*)dat.begin(), dat.size());
-    }
+    playback_ns.store(event->mono_time, std::memory_order_relaxed);
   }
   return true;
 }
 
+void ReplayStream::updatePlayback() {
+  const uint64_t target = playback_ns.load(std::memory_order_relaxed);
+  if (!seek_in_progress && !stepped && target > cursor_ns) {
+    auto first = std::ranges::upper_bound(all_events_, cursor_ns, {}, &CanEvent::mono_ns);
+    auto last = std::ranges::upper_bound(first, all_events_.end(), target, {}, &CanEvent::mono_ns);
+    if (first != last) {
+      processNewMessages(first, last, getSpeed() > 1.0);
+      // Stop at the last merged event, so a segment still being decoded is picked up once merged
+      cursor_ns = (*std::prev(last))->mono_ns;
+    }
+  }
+  commitSnapshots();
+  if (segment_prefetcher) {
+    segment_prefetcher->update(toSeconds(cursor_ns), getSpeed(), isPlayingReverse());
+  }
+}
+
 void ReplayStream::pause(bool pause) {
+  if (!pause && stepped) {
+    stepped = false;
+    seekTo(toSeconds(cursor_ns));
+  }
   replay->pause(pause);
   emit(pause ? paused() : resume());
 }
+
+void ReplayStream::prefetchHint(double sec) {
+  if (segment_prefetcher) segment_prefetcher->hover(sec);
+}
+
+void ReplayStream::setPlaybackPosition(uint64_t mono_ns) {
+  cursor_ns = mono_ns;
+  stepped = true;
+}
@@ -1,12 +1,16 @@
 #pragma once
 
+#include <QFuture>
 #include <algorithm>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <vector>
 
 #include "abstract_stream.h"
 #include "common/prefix.h"
+#include "core/streams/segment_prefetcher.h"
 #include "replay/include/replay.h"
 
 Q_DECLARE_METATYPE(std::shared_ptr<LogReader>);
@@ -18,6 +22,7 @@ class ReplayStream : public AbstractStream {
 
  public:
   ReplayStream(QObject* parent);
+  ~ReplayStream() override;
   void start() override { replay->start(); }
   bool loadRoute(const QString& route, const QString& data_dir, uint32_t replay_flags = REPLAY_FLAG_NONE,
                  bool auto_source = false);
@@ -35,11 +40,27 @@ class ReplayStream : public AbstractStream {
   inline Replay* getReplay() const { return replay.get(); }
   inline bool isPaused() const override { return replay->isPaused(); }
   void pause(bool pause) override;
+  void prefetchHint(double sec);  // Timeline position under the mouse, negative when there is none
+  inline const SegmentPrefetcher* prefetcher() const { return segment_prefetcher.get(); }
+
+ protected:
+  void setPlaybackPosition(uint64_t mono_ns) override;
 
  private:
   void mergeSegments();
+  void updatePlayback();
   std::unique_ptr<Replay> replay = nullptr;
-  std::set<int> processed_segments;
+  std::set<int> processed_segments;  // Replay thread only
+  std::mutex decode_mutex;
+  std::vector<QFuture<void>> decode_tasks;
   std::unique_ptr<OpenpilotPrefix> op_prefix;
+  std::unique_ptr<SegmentPrefetcher> segment_prefetcher;
   QTimer* ui_update_timer = nullptr;
+
+  // Playback position published by the replay thread. The GUI thread feeds processNewMessages()
+  // from the merged timeline up to it, so each CAN event is only decoded once.
+  std::atomic<uint64_t> playback_ns{0};
+  uint64_t cursor_ns = 0;  // Last event fed to processNewMessages(), main thread only
+  bool seek_in_progress = false;
+  bool stepped = false;  // Moved by frame stepping, replay catches up with a seek on resume
 };
@@ -0,0 +1,145 @@
+#include "segment_prefetcher.h"
+
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+
+#include "common/timing.h"
+#include "replay/include/filereader.h"
+
+namespace {
+
+constexpr int kMaxFetches = 2;
+constexpr int kMaxAhead = 8;
+constexpr double kSegmentSeconds = 60.0;
+constexpr double kLookaheadSeconds = 30.0;           // Playback time to stay ahead of, scaled by speed
+constexpr uint64_t kHoverDwellNs = 300'000'000;      // Hovers shorter than this are just the mouse passing by
+constexpr uint64_t kSeekPatternNs = 2'000'000'000;   // Seeks closer together than this continue a pattern
+constexpr uint64_t kReplanIntervalNs = 250'000'000;
+
+}  // namespace
+
+SegmentPrefetcher::SegmentPrefetcher(std::map<int, std::string> log_urls, std::function<bool(int)> is_loaded)
+    : log_urls_(std::move(log_urls)), is_loaded_(std::move(is_loaded)) {
+  pool_.setMaxThreadCount(kMaxFetches);
+  // Local routes are read straight from disk
+  std::erase_if(log_urls_, [](const auto& item) { return item.second.rfind("http", 0) != 0; });
+}
+
+SegmentPrefetcher::~SegmentPrefetcher() {
+  abort_ = true;
+  {
+    std::lock_guard lk(lock_);
+    wanted_.clear();
+  }
+  pool_.waitForDone();
+
+  const Stats s = stats();
+  if (s.hits + s.misses > 0) {
+    qInfo() << "SegmentPrefetcher:" << s.hits << "of" << s.hits + s.misses << "segments prefetched in time,"
+            << s.fetched << "fetched," << s.failed << "failed";
+  }
+}
+
+int SegmentPrefetcher::segmentAt(double sec) const { return sec < 0 ? -1 : int(sec / kSegmentSeconds); }
+
+void SegmentPrefetcher::hover(double sec) {
+  const int n = segmentAt(sec);
+  if (n != hover_segment_) {
+    hover_segment_ = n;
+    hover_since_ns_ = nanos_since_boot();
+  }
+}
+
+void SegmentPrefetcher::seeked(double sec) {
+  const uint64_t now = nanos_since_boot();
+  if (last_seek_sec_ >= 0 && now - last_seek_ns_ < kSeekPatternNs && sec != last_seek_sec_) {
+    seek_dir_ = sec > last_seek_sec_ ? 1 : -1;
+    seek_step_ = std::max(1, std::abs(segmentAt(sec) - segmentAt(last_seek_sec_)));
+  } else {
+    seek_dir_ = 0;
+  }
+  last_seek_sec_ = sec;
+  last_seek_ns_ = now;
+}
+
+void SegmentPrefetcher::update(double sec, double speed, bool reverse) {
+  if (log_urls_.empty()) return;
+
+  const uint64_t now = nanos_since_boot();
+  const int n = segmentAt(sec);
+  const bool entered = n != current_segment_;
+  if (entered) {
+    current_segment_ = n;
+    std::lock_guard lk(lock_);
+    auto it = states_.find(n);
+    if (it != states_.end() && it->second == State::Done) {
+      ++stats_.hits;
+    } else if (log_urls_.count(n) && !is_loaded_(n)) {
+      ++stats_.misses;
+    }
+  }
+
+  if (!entered && now - last_plan_ns_ < kReplanIntervalNs) return;
+  last_plan_ns_ = now;
+
+  // Most urgent first: the segment being played, the one the user is looking at, where the
+  // seeks are heading, then what playback reaches next
+  std::vector<int> plan = {n};
+  if (hover_segment_ >= 0 && now - hover_since_ns_ >= kHoverDwellNs) {
+    plan.push_back(hover_segment_);
+  }
+  if (seek_dir_ != 0 && now - last_seek_ns_ < kSeekPatternNs) {
+    for (int k = 1; k <= 2; ++k) plan.push_back(n + seek_dir_ * seek_step_ * k);
+  }
+  const int dir = reverse ? -1 : 1;
+  const double lookahead = std::max(speed, 1.0) * kLookaheadSeconds;
+  const int ahead = std::clamp((int)std::ceil(lookahead / kSegmentSeconds), 1, kMaxAhead);
+  for (int i = 1; i <= ahead; ++i) plan.push_back(n + dir * i);
+
+  std::vector<int> wanted;
+  for (int seg : plan) {
+    if (log_urls_.count(seg) && std::find(wanted.begin(), wanted.end(), seg) == wanted.end() && !is_loaded_(seg)) {
+      wanted.push_back(seg);
+    }
+  }
+
+  std::lock_guard lk(lock_);
+  std::erase_if(wanted, [this](int seg) { return states_.count(seg) > 0; });
+  wanted_ = std::move(wanted);
+  while (active_fetches_ < kMaxFetches && active_fetches_ < (int)wanted_.size()) {
+    ++active_fetches_;
+    pool_.start([this]() { fetchThread(); });
+  }
+}
+
+// Pool thread. Keeps taking the most urgent segment until there is nothing left to fetch.
+void SegmentPrefetcher::fetchThread() {
+  std::unique_lock lk(lock_);
+  while (!abort_) {
+    auto it = std::find_if(wanted_.begin(), wanted_.end(), [this](int seg) { return states_.count(seg) == 0; });
+    if (it == wanted_.end()) break;
+
+    const int n = *it;
+    wanted_.erase(it);
+    states_[n] = State::Fetching;
+    ++stats_.requested;
+    lk.unlock();
+
+    // The cache reader stores the file where the replay loader will look for it
+    const bool ok = !FileReader(true).read(log_urls_.at(n), &abort_).empty();
+
+    lk.lock();
+    states_[n] = ok ? State::Done : State::Failed;
+    ++(ok ? stats_.fetched : stats_.failed);
+    if (!ok && !abort_) {
+      qWarning() << "SegmentPrefetcher: failed to fetch segment" << n;
+    }
+  }
+  --active_fetches_;
+}
+
+SegmentPrefetcher::Stats SegmentPrefetcher::stats() const {
+  std::lock_guard lk(lock_);
+  return stats_;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <QThreadPool>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Downloads route segments before playback reaches them, so scrubbing and fast playback don't
+// stall on unloaded segments. The segments to fetch are predicted from the playback position,
+// speed and direction, the segment hovered on the timeline and the direction of recent seeks.
+// Fetches go into the download cache the replay loader reads from, nearest segment first.
+class SegmentPrefetcher {
+ public:
+  struct Stats {
+    uint64_t requested;
+    uint64_t fetched;
+    uint64_t failed;
+    uint64_t hits;    // Segments entered after their prefetch had finished
+    uint64_t misses;  // Segments entered while still unloaded and not prefetched
+  };
+
+  // `log_urls` maps segment numbers to their log file; `is_loaded` is only called from update()
+  SegmentPrefetcher(std::map<int, std::string> log_urls, std::function<bool(int)> is_loaded);
+  ~SegmentPrefetcher();
+
+  // All called from the GUI thread
+  void update(double sec, double speed, bool reverse);
+  void hover(double sec);  // Negative when the mouse leaves the timeline
+  void seeked(double sec);
+  Stats stats() const;
+
+ private:
+  enum class State { Fetching, Done, Failed };
+
+  void fetchThread();
+  int segmentAt(double sec) const;
+
+  std::map<int, std::string> log_urls_;
+  const std::function<bool(int)> is_loaded_;
+  QThreadPool pool_;
+  std::atomic<bool> abort_{false};
+
+  mutable std::mutex lock_;
+  std::vector<int> wanted_;        // Segments to fetch, most urgent first
+  std::map<int, State> states_;    // Segments requested so far
+  int active_fetches_ = 0;
+  Stats stats_ = {};
+
+  int current_segment_ = -1;
+  uint64_t last_plan_ns_ = 0;
+  int hover_segment_ = -1;
+  uint64_t hover_since_ns_ = 0;
+  double last_seek_sec_ = -1;
+  uint64_t last_seek_ns_ = 0;
+  int seek_dir_ = 0;   // Direction of the last seeks if they kept going one way
+  int seek_step_ = 0;  // Segments covered by the last seek
+};
@@ -1,71 +1,326 @@
 #include "socket_can_stream.h"
 
 #include <QDebug>
+#include <QDir>
+#include <QFile>
 #include <QThread>
 
-SocketCanStream::SocketCanStream(QObject* parent, SocketCanStreamConfig config_) : LiveStream(parent), config(config_) {
-  if (!available()) {
-    throw std::runtime_error("SocketCAN plugin not available");
-  }
+#include "common/timing.h"
+
+#ifdef __linux__
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#include <linux/errqueue.h>
+#include <linux/net_tstamp.h>
+#include <net/if.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+namespace {
+
+constexpr int kBatchSize = 64;  // Frames per recvmmsg() call
+constexpr int kMaxInterfaces = 16;
+constexpr int kReceiveBufferSize = 4 << 20;
+constexpr int64_t kHwResyncThresholdNs = 50'000'000;  // Re-anchor hardware clock if it drifts this far
+constexpr uint16_t kArphrdCan = 280;                  // ARPHRD_CAN, from /sys/class/net/<iface>/type
+constexpr double kDropReportIntervalSec = 1.0;
+
+// Interfaces are read one after another, so a frame read from one may be older than
+// frames already read from another. Frames are held this long and released in
+// timestamp order; it also bounds the epoll wait.
+constexpr int kReorderWindowMs = 10;
+constexpr uint64_t kReorderWindowNs = kReorderWindowMs * 1'000'000ULL;
+
+constexpr size_t kControlSize = CMSG_SPACE(sizeof(scm_timestamping)) + CMSG_SPACE(sizeof(uint32_t));
+
+struct PendingFrame {
+  uint64_t mono_ns;
+  uint32_t address;
+  uint8_t bus;
+  uint8_t size;
+  uint8_t data[CANFD_MAX_DLEN];
+};
 
-  qDebug() << "Connecting to SocketCAN device" << config.device;
+inline uint64_t toNanos(const timespec& ts) { return ts.tv_sec * 1'000'000'000ULL + ts.tv_nsec; }
+
+int64_t realtimeToBootNs() {
+  timespec realtime;
+  clock_gettime(CLOCK_REALTIME, &realtime);
+  return static_cast<int64_t>(nanos_since_boot()) - static_cast<int64_t>(toNanos(realtime));
+}
+
+}  // namespace
+
+SocketCanStream::SocketCanStream(QObject* parent, SocketCanStreamConfig config_) : LiveStream(parent), config(config_) {
+  qDebug() << "Connecting to SocketCAN devices" << config.devices;
   if (!connect()) {
+    closeAll();
     throw std::runtime_error("Failed to connect to SocketCAN device");
   }
 }
 
-bool SocketCanStream::available() { return QCanBus::instance()->plugins().contains("socketcan"); }
+SocketCanStream::~SocketCanStream() {
+  stop();
+  for (const auto& s : interfaceStats()) {
+    qInfo() << "SocketCAN" << s.device << "bus" << s.bus << "frames:" << s.frames << "dropped:" << s.dropped;
+  }
+  closeAll();
+}
+
+bool SocketCanStream::available() {
+  int fd = socket(PF_CAN, SOCK_RAW | SOCK_CLOEXEC, CAN_RAW);
+  if (fd < 0) return false;
+  close(fd);
+  return true;
+}
+
+QStringList SocketCanStream::availableDevices() {
+  QStringList devices;
+  for (const QString& iface : QDir("/sys/class/net").entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name)) {
+    QFile type_file(QString("/sys/class/net/%1/type").arg(iface));
+    if (type_file.open(QIODevice::ReadOnly) && type_file.readAll().trimmed().toUInt() == kArphrdCan) {
+      devices.push_back(iface);
+    }
+  }
+  return devices;
+}
+
+std::vector<SocketCanStream::InterfaceStats> SocketCanStream::interfaceStats() const {
+  std::vector<InterfaceStats> stats;
+  for (const auto& iface : interfaces) {
+    stats.push_back({iface->device, iface->bus, iface->frames.load(), iface->dropped.load()});
+  }
+  return stats;
+}
 
 bool SocketCanStream::connect() {
-  // Connecting might generate some warnings about missing socketcan/libsocketcan libraries
-  // These are expected and can be ignored, we don't need the advanced features of libsocketcan
-  QString errorString;
-  device.reset(QCanBus::instance()->createDevice("socketcan", config.device, &errorString));
-  if (!device) {
-    qDebug() << "Failed to create SocketCAN device" << errorString;
+  if (config.devices.isEmpty() || config.devices.size() > kMaxInterfaces) {
+    qDebug() << "Expected 1 to" << kMaxInterfaces << "SocketCAN devices, got" << config.devices.size();
+    return false;
+  }
+
+  epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (epoll_fd < 0) {
+    qDebug() << "Failed to create epoll instance:" << strerror(errno);
+    return false;
+  }
+
+  for (const QString& device : config.devices) {
+    auto& iface = interfaces.emplace_back(std::make_unique<Interface>());
+    iface->device = device;
+    iface->bus = static_cast<uint8_t>(interfaces.size() - 1);
+    if (!openInterface(*iface)) return false;
+
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.u32 = iface->bus;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, iface->fd, &ev) < 0) {
+      qDebug() << "Failed to watch" << device << strerror(errno);
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SocketCanStream::openInterface(Interface& iface) {
+  const QByteArray name = iface.device.toUtf8();
+  if (name.isEmpty() || name.size() >= IFNAMSIZ) {
+    qDebug() << "Invalid SocketCAN device name" << iface.device;
     return false;
   }
 
-  device->setConfigurationParameter(QCanBusDevice::CanFdKey, true);
+  iface.fd = socket(PF_CAN, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, CAN_RAW);
+  if (iface.fd < 0) {
+    qDebug() << "Failed to create CAN socket:" << strerror(errno);
+    return false;
+  }
 
-  if (!device->connectDevice()) {
-    qDebug() << "Failed to connect to device";
+  ifreq ifr = {};
+  std::memcpy(ifr.ifr_name, name.constData(), name.size());
+  if (ioctl(iface.fd, SIOCGIFINDEX, &ifr) < 0) {
+    qDebug() << "Unknown SocketCAN device" << iface.device << strerror(errno);
     return false;
   }
 
+  // Best effort: CAN FD needs kernel support, hardware timestamps need driver support
+  const int enable = 1;
+  setsockopt(iface.fd, SOL_CAN_RAW, CAN_RAW_FD_FRAMES, &enable, sizeof(enable));
+  setsockopt(iface.fd, SOL_SOCKET, SO_RXQ_OVFL, &enable, sizeof(enable));
+  const int ts_flags = SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE | SOF_TIMESTAMPING_RX_SOFTWARE |
+                       SOF_TIMESTAMPING_SOFTWARE;
+  if (setsockopt(iface.fd, SOL_SOCKET, SO_TIMESTAMPING, &ts_flags, sizeof(ts_flags)) < 0) {
+    qDebug() << "SO_TIMESTAMPING not supported on" << iface.device << ", falling back to arrival time";
+  }
+  setsockopt(iface.fd, SOL_SOCKET, SO_RCVBUF, &kReceiveBufferSize, sizeof(kReceiveBufferSize));
+
+  sockaddr_can addr = {};
+  addr.can_family = AF_CAN;
+  addr.can_ifindex = ifr.ifr_ifindex;
+  if (bind(iface.fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+    qDebug() << "Failed to bind CAN socket to" << iface.device << strerror(errno);
+    return false;
+  }
   return true;
 }
 
+void SocketCanStream::closeAll() {
+  for (auto& iface : interfaces) {
+    if (iface->fd >= 0) close(iface->fd);
+    iface->fd = -1;
+  }
+  if (epoll_fd >= 0) close(epoll_fd);
+  epoll_fd = -1;
+}
+
+// Returns the frame's receive time on the boot clock. Prefers the hardware timestamp,
+// then the kernel software timestamp, then the current time. Also picks up the
+// socket's cumulative drop counter.
+uint64_t SocketCanStream::frameTimestamp(msghdr& hdr, Interface& iface, int64_t realtime_to_boot_ns) {
+  uint64_t mono_ns = 0;
+  for (cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); cmsg; cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
+    if (cmsg->cmsg_level != SOL_SOCKET) continue;
+
+    if (cmsg->cmsg_type == SO_RXQ_OVFL) {
+      uint32_t dropped;
+      std::memcpy(&dropped, CMSG_DATA(cmsg), sizeof(dropped));
+      iface.dropped.store(dropped, std::memory_order_relaxed);
+    } else if (cmsg->cmsg_type == SCM_TIMESTAMPING) {
+      scm_timestamping ts;
+      std::memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+      const uint64_t sw_ns = toNanos(ts.ts[0]);
+      const uint64_t hw_ns = toNanos(ts.ts[2]);
+      const int64_t sw_boot_ns = sw_ns ? static_cast<int64_t>(sw_ns) + realtime_to_boot_ns : nanos_since_boot();
+      mono_ns = sw_boot_ns;
+
+      if (hw_ns) {
+        const int64_t mapped = static_cast<int64_t>(hw_ns) + iface.hw_offset_ns;
+        if (!iface.hw_offset_valid || std::abs(mapped - sw_boot_ns) > kHwResyncThresholdNs) {
+          iface.hw_offset_ns = sw_boot_ns - static_cast<int64_t>(hw_ns);
+          iface.hw_offset_valid = true;
+        }
+        mono_ns = hw_ns + iface.hw_offset_ns;
+      }
+    }
+  }
+  return mono_ns ? mono_ns : nanos_since_boot();
+}
+
+void SocketCanStream::reportDrops() {
+  for (auto& iface : interfaces) {
+    const uint32_t dropped = iface->dropped.load(std::memory_order_relaxed);
+    if (dropped != iface->reported_drops) {
+      qWarning() << "SocketCAN" << iface->device << "dropped" << (dropped - iface->reported_drops)
+                 << "frames (total" << dropped << ")";
+      iface->reported_drops = dropped;
+    }
+  }
+}
+
 void SocketCanStream::streamThread() {
+  std::array<canfd_frame, kBatchSize> frames;
+  std::array<iovec, kBatchSize> iovs;
+  std::array<mmsghdr, kBatchSize> msgs;
+  alignas(cmsghdr) std::array<std::array<char, kControlSize>, kBatchSize> controls;
+  std::array<epoll_event, kMaxInterfaces> ready;
+
+  std::vector<PendingFrame> pending;
+  std::vector<const CanEvent*> events;
+  double last_drop_report = millis_since_boot() / 1000.0;
+
   while (!QThread::currentThread()->isInterruptionRequested()) {
-    QThread::msleep(1);
+    const int n = epoll_wait(epoll_fd, ready.data(), ready.size(), kReorderWindowMs);
+    const int64_t realtime_to_boot_ns = realtimeToBootNs();
 
-    auto frames = device->readAllFrames();
-    if (frames.size() == 0) continue;
+    for (int r = 0; r < n; ++r) {
+      Interface& iface = *interfaces[ready[r].data.u32];
+      for (int i = 0; i < kBatchSize; ++i) {
+        iovs[i] = {&frames[i], sizeof(canfd_frame)};
+        msgs[i] = {};
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        msgs[i].msg_hdr.msg_control = controls[i].data();
+        msgs[i].msg_hdr.msg_controllen = controls[i].size();
+      }
 
-    // Count valid frames first to avoid ghost entries in the capnp message
-    size_t valid_count = 0;
-    for (const auto& f : frames) {
-      if (f.isValid()) ++valid_count;
-    }
-    if (valid_count == 0) continue;
+      const int count = recvmmsg(iface.fd, msgs.data(), kBatchSize, MSG_DONTWAIT, nullptr);
+      if (count < 0 && errno != EAGAIN && errno != EINTR) {
+        qDebug() << "recvmmsg failed on" << iface.device << strerror(errno);
+        QThread::msleep(100);
+      }
+
+      for (int i = 0; i < count; ++i) {
+        const canfd_frame& frame = frames[i];
+        if (msgs[i].msg_len != CAN_MTU && msgs[i].msg_len != CANFD_MTU) continue;
+        if (frame.can_id & (CAN_RTR_FLAG | CAN_ERR_FLAG)) continue;
 
-    MessageBuilder msg;
-    auto evt = msg.initEvent();
-    auto canData = evt.initCan(valid_count);
+        PendingFrame& p = pending.emplace_back();
+        p.mono_ns = frameTimestamp(msgs[i].msg_hdr, iface, realtime_to_boot_ns);
+        p.address = frame.can_id & ((frame.can_id & CAN_EFF_FLAG) ? CAN_EFF_MASK : CAN_SFF_MASK);
+        p.bus = iface.bus;
+        p.size = std::min<uint8_t>(frame.len, CANFD_MAX_DLEN);
+        std::memcpy(p.data, frame.data, p.size);
+      }
+      if (count > 0) iface.frames.fetch_add(count, std::memory_order_relaxed);
+    }
 
-    size_t j = 0;
-    for (const auto& frame : frames) {
-      if (!frame.isValid()) continue;
+    // Release frames that are older than the reorder window, in timestamp order
+    if (!pending.empty()) {
+      std::stable_sort(pending.begin(), pending.end(), [](auto& a, auto& b) { return a.mono_ns < b.mono_ns; });
+      const uint64_t horizon = nanos_since_boot() - kReorderWindowNs;
+      auto end = std::upper_bound(pending.begin(), pending.end(), horizon,
+                                  [](uint64_t t, const PendingFrame& f) { return t < f.mono_ns; });
 
-      canData[j].setAddress(frame.frameId());
-      canData[j].setSrc(0);
+      events.clear();
+      for (auto it = pending.begin(); it != end; ++it) {
+        // A frame later than the window (e.g. a slow hardware clock) is pinned to keep the stream ordered
+        last_mono_ns = std::max(last_mono_ns, it->mono_ns);
+        events.push_back(newEvent(last_mono_ns, it->bus, it->address, it->data, it->size));
+      }
+      pending.erase(pending.begin(), end);
+      handleEvents(events);
+    }
 
-      auto payload = frame.payload();
-      canData[j].setDat(kj::arrayPtr((uint8_t*)payload.data(), payload.size()));
-      ++j;
+    const double now = millis_since_boot() / 1000.0;
+    if (now - last_drop_report >= kDropReportIntervalSec) {
+      reportDrops();
+      last_drop_report = now;
     }
+  }
+}
+
+#else
+
+SocketCanStream::SocketCanStream(QObject* parent, SocketCanStreamConfig config_) : LiveStream(parent), config(config_) {
+  throw std::runtime_error("SocketCAN is only available on Linux");
+}
+
+SocketCanStream::~SocketCanStream() { stop(); }
+
+bool SocketCanStream::available() { return false; }
+QStringList SocketCanStream::availableDevices() { return {}; }
+std::vector<SocketCanStream::InterfaceStats> SocketCanStream::interfaceStats() const { return {}; }
+bool SocketCanStream::connect() { return false; }
+bool SocketCanStream::openInterface(Interface& iface) { return false; }
+uint64_t SocketCanStream::frameTimestamp(msghdr& hdr, Interface& iface, int64_t realtime_to_boot_ns) { return 0; }
+void SocketCanStream::reportDrops() {}
+void SocketCanStream::closeAll() {}
+void SocketCanStream::streamThread() {}
+
+#endif
 
-    handleEvent(capnp::messageToFlatArray(msg));
+QStringList SocketCanStream::statsLines() const {
+  QStringList lines = LiveStream::statsLines();
+  for (const auto& s : interfaceStats()) {
+    lines << tr("SocketCAN %1 (bus %2): %3 frames, %4 dropped").arg(s.device).arg(s.bus).arg(s.frames).arg(s.dropped);
   }
+  return lines;
 }
@@ -1,29 +1,67 @@
 #pragma once
 
-#include <QtSerialBus/QCanBus>
-#include <QtSerialBus/QCanBusDevice>
-#include <QtSerialBus/QCanBusDeviceInfo>
+#include <QStringList>
+#include <atomic>
 #include <memory>
+#include <vector>
 
 #include "live_stream.h"
 
+struct msghdr;
+
 struct SocketCanStreamConfig {
-  QString device = "";  // TODO: support multiple devices/buses at once
+  QStringList devices;  // Each interface is mapped to its own bus, in list order
 };
 
+// Reads one or more raw PF_CAN sockets on a single thread multiplexed with epoll.
+// Frames are received in batches with recvmmsg(), stamped with the kernel's
+// SO_TIMESTAMPING timestamps and merged across interfaces in timestamp order.
 class SocketCanStream : public LiveStream {
   Q_OBJECT
  public:
+  struct InterfaceStats {
+    QString device;
+    uint8_t bus;
+    uint64_t frames;
+    uint32_t dropped;
+  };
+
   SocketCanStream(QObject* parent, SocketCanStreamConfig config_ = {});
-  ~SocketCanStream() { stop(); }
+  ~SocketCanStream();
   static bool available();
+  static QStringList availableDevices();
+  std::vector<InterfaceStats> interfaceStats() const;
+  QStringList statsLines() const override;
 
-  inline QString routeName() const override { return QString("Live Streaming From Socket CAN %1").arg(config.device); }
+  inline QString routeName() const override {
+    return QString("Live Streaming From Socket CAN %1").arg(config.devices.join(", "));
+  }
 
  protected:
+  struct Interface {
+    QString device;
+    uint8_t bus = 0;
+    int fd = -1;
+
+    // Hardware timestamps come from the controller's clock; they are shifted onto
+    // the boot clock using the software timestamp of the same frame.
+    int64_t hw_offset_ns = 0;
+    bool hw_offset_valid = false;
+
+    std::atomic<uint64_t> frames{0};
+    std::atomic<uint32_t> dropped{0};  // Kernel receive queue overflows (SO_RXQ_OVFL)
+    uint32_t reported_drops = 0;
+  };
+
   void streamThread() override;
   bool connect();
+  bool openInterface(Interface& iface);
+  uint64_t frameTimestamp(msghdr& hdr, Interface& iface, int64_t realtime_to_boot_ns);
+  void reportDrops();
+  void closeAll();
 
   SocketCanStreamConfig config = {};
-  std::unique_ptr<QCanBusDevice> device;
+  std::vector<std::unique_ptr<Interface>> interfaces;
+  int epoll_fd = -1;
+  uint64_t last_mono_ns = 0;
 };
@@ -0,0 +1,202 @@
+#include "synthetic_stream.h"
+
+#include <QDebug>
+#include <QHash>
+#include <QTextStream>
+#include <QThread>
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+#include <numbers>
+#include <stdexcept>
+#include <tuple>
+
+#include "common/timing.h"
+
+namespace {
+
+constexpr int kTickMs = 1;
+constexpr int kMaxBuses = 16;
+constexpr int kMaxFrameSize = 64;
+constexpr int kMaxBuiltinMessages = 1024;
+constexpr int kMuxGroups = 4;
+
+// A counter and a run of 16-bit signals per message, mixing byte orders and signedness.
+// Every fourth message is multiplexed, with each multiplex group reusing the same bytes.
+QString builtinDbc(int messages, bool can_fd) {
+  const int size = can_fd ? kMaxFrameSize : 8;
+  QString content;
+  QTextStream out(&content);
+  for (int i = 0; i < messages; ++i) {
+    const bool muxed = i % 4 == 3;
+    out << "BO_ " << 0x100 + i << " SYNTHETIC_" << i << ": " << size << " XXX\n";
+    out << " SG_ COUNTER : 0|4@1+ (1,0) [0|15] \"\" XXX\n";
+    if (muxed) out << " SG_ MUX M : 4|4@1+ (1,0) [0|3] \"\" XXX\n";
+
+    for (int group = 0; group < (muxed ? kMuxGroups : 1); ++group) {
+      for (int byte = 1, k = 0; byte + 2 <= size; byte += 2, ++k) {
+        const bool little_endian = (i + k) % 3 != 0;
+        const int start_bit = little_endian ? byte * 8 : byte * 8 + 7;  // Big endian starts at the MSB
+        out << " SG_ SIG_" << group << "_" << k << (muxed ? QString(" m%1").arg(group) : QString()) << " : "
+            << start_bit << "|16@" << (little_endian ? "1" : "0") << (k % 2 ? "-" : "+")
+            << " (0.01,0) [0|0] \"\" XXX\n";
+      }
+    }
+  }
+  out.flush();
+  return content;
+}
+
+inline uint64_t rawMask(int size) { return size >= 64 ? ~0ULL : (1ULL << size) - 1; }
+
+uint64_t toRaw(const dbc::Signal* sig, double value) {
+  const double raw_min = sig->is_signed ? -std::ldexp(1.0, sig->size - 1) : 0;
+  const double raw_max = sig->is_signed ? std::ldexp(1.0, sig->size - 1) - 1 : std::ldexp(1.0, sig->size) - 1;
+  const double raw = std::clamp(std::round((value - sig->offset) / sig->factor), raw_min, raw_max);
+  return static_cast<uint64_t>(static_cast<int64_t>(raw)) & rawMask(sig->size);
+}
+
+void writeRaw(const dbc::Signal* sig, uint64_t raw, uint8_t* dat, int size) {
+  for (int i = 0; i < sig->size; ++i) {
+    const int bit = sig->getBitIndex(i);
+    if (bit < 0 || bit / 8 >= size) continue;
+
+    // getBitIndex walks from the LSB for little endian signals and from the MSB for big endian ones
+    const int value_bit = sig->is_little_endian ? i : sig->size - 1 - i;
+    const uint8_t mask = 1 << (bit & 7);
+    dat[bit / 8] = ((raw >> value_bit) & 1) ? (dat[bit / 8] | mask) : (dat[bit / 8] & ~mask);
+  }
+}
+
+bool nameContains(const QString& name, std::initializer_list<const char*> words) {
+  return std::any_of(words.begin(), words.end(), [&](const char* w) { return name.contains(w, Qt::CaseInsensitive); });
+}
+
+}  // namespace
+
+SyntheticStream::SyntheticStream(QObject* parent, SyntheticStreamConfig config_) : LiveStream(parent), config(config_) {
+  config.rate = std::max(1, config.rate);
+  config.buses = std::clamp(config.buses, 1, kMaxBuses);
+  config.messages = std::clamp(config.messages, 1, kMaxBuiltinMessages);
+
+  if (config.dbc_file.isEmpty()) {
+    source_dbc = std::make_unique<dbc::File>("synthetic", builtinDbc(config.messages, config.can_fd));
+  } else {
+    source_dbc = std::make_unique<dbc::File>(config.dbc_file);
+  }
+  buildGenerators();
+  if (generators.empty()) {
+    throw std::runtime_error("No messages to generate");
+  }
+  qDebug() << "Generating" << generators.size() << "messages at" << config.rate << "frames/s on" << config.buses
+           << "bus(es)";
+}
+
+SyntheticStream::~SyntheticStream() {
+  stop();
+  qInfo() << "SyntheticStream: generated" << generatedFrames() << "frames";
+}
+
+void SyntheticStream::buildGenerators() {
+  for (const auto& [address, msg] : source_dbc->getMessages()) {
+    MessageGen gen = {.address = address, .size = (uint8_t)std::min<uint32_t>(msg.size, kMaxFrameSize)};
+    gen.multiplexor = msg.multiplexor;
+    for (const dbc::Signal* sig : msg.sigs) {
+      if (sig->size <= 0 || sig->factor == 0 || sig->type == dbc::Signal::Type::Multiplexor) continue;
+      if (sig->type == dbc::Signal::Type::Multiplexed && gen.multiplexor) {
+        gen.mux_values.push_back(sig->multiplex_value);
+      }
+
+      // Pick a pattern from the name where it tells one, otherwise spread them over the signals
+      const size_t h = qHash(sig->name) ^ address;
+      SignalGen s = {.sig = sig, .pattern = Pattern::Sine, .period = 1.0 + h % 10, .min = sig->min, .max = sig->max};
+      if (nameContains(sig->name, {"COUNTER", "CNT"})) {
+        s.pattern = Pattern::Counter;
+      } else if (nameContains(sig->name, {"CHECKSUM", "CRC"})) {
+        s.pattern = Pattern::Noise;
+      } else if (sig->size == 1) {
+        s.pattern = Pattern::Square;
+      } else {
+        constexpr Pattern patterns[] = {Pattern::Sine, Pattern::Ramp, Pattern::Sine, Pattern::Noise};
+        s.pattern = patterns[h % std::size(patterns)];
+      }
+
+      if (s.max <= s.min) {
+        // No range in the DBC, use the whole raw range
+        const double raw_min = sig->is_signed ? -std::ldexp(1.0, sig->size - 1) : 0;
+        const double raw_max = sig->is_signed ? std::ldexp(1.0, sig->size - 1) - 1 : std::ldexp(1.0, sig->size) - 1;
+        std::tie(s.min, s.max) = std::minmax(raw_min * sig->factor + sig->offset, raw_max * sig->factor + sig->offset);
+      }
+      gen.sigs.push_back(s);
+    }
+
+    std::sort(gen.mux_values.begin(), gen.mux_values.end());
+    gen.mux_values.erase(std::unique(gen.mux_values.begin(), gen.mux_values.end()), gen.mux_values.end());
+    if (gen.size > 0) generators.push_back(std::move(gen));
+  }
+}
+
+// `n` is the message's frame number and `t` the frame time in seconds since the stream started
+void SyntheticStream::fillFrame(const MessageGen& msg, uint64_t n, double t, uint8_t* dat) {
+  std::fill_n(dat, msg.size, 0);
+  const int mux = msg.mux_values.empty() ? 0 : msg.mux_values[n % msg.mux_values.size()];
+  if (!msg.mux_values.empty()) {
+    writeRaw(msg.multiplexor, mux & rawMask(msg.multiplexor->size), dat, msg.size);
+  }
+
+  for (const SignalGen& s : msg.sigs) {
+    if (s.sig->type == dbc::Signal::Type::Multiplexed && !msg.mux_values.empty() && s.sig->multiplex_value != mux) {
+      continue;
+    }
+
+    uint64_t raw = 0;
+    const double phase = std::fmod(t, s.period) / s.period;
+    switch (s.pattern) {
+      case Pattern::Counter: raw = n & rawMask(s.sig->size); break;
+      case Pattern::Ramp: raw = toRaw(s.sig, s.min + (s.max - s.min) * phase); break;
+      case Pattern::Sine:
+        raw = toRaw(s.sig, (s.min + s.max) / 2 + (s.max - s.min) / 2 * std::sin(2 * std::numbers::pi * phase));
+        break;
+      case Pattern::Square: raw = toRaw(s.sig, phase < 0.5 ? s.min : s.max); break;
+      case Pattern::Noise:
+        // xorshift64
+        noise_state ^= noise_state << 13;
+        noise_state ^= noise_state >> 7;
+        noise_state ^= noise_state << 17;
+        raw = noise_state & rawMask(s.sig->size);
+        break;
+    }
+    writeRaw(s.sig, raw, dat, msg.size);
+  }
+}
+
+void SyntheticStream::streamThread() {
+  const uint64_t slots = generators.size() * config.buses;
+  const double frame_ns = 1e9 / config.rate;
+  const uint64_t start_ns = nanos_since_boot();
+  uint64_t sent = 0;
+  std::vector<const CanEvent*> events;
+  uint8_t dat[kMaxFrameSize];
+
+  while (!QThread::currentThread()->isInterruptionRequested()) {
+    const uint64_t due = (nanos_since_boot() - start_ns) / frame_ns;
+    // Skip ahead after a stall instead of releasing more than a second of traffic at once
+    sent = std::max(sent, due > (uint64_t)config.rate ? due - config.rate : 0);
+
+    events.clear();
+    for (; sent < due; ++sent) {
+      // Each message goes out on every bus in turn before the next message
+      const uint64_t slot = sent % slots;
+      const MessageGen& msg = generators[slot / config.buses];
+      const uint64_t mono_ns = start_ns + sent * frame_ns;
+      fillFrame(msg, sent / slots, (mono_ns - start_ns) / 1e9, dat);
+      events.push_back(newEvent(mono_ns, slot % config.buses, msg.address, dat, msg.size));
+    }
+
+    if (!events.empty()) {
+      handleEvents(events);
+      generated.fetch_add(events.size(), std::memory_order_relaxed);
+    }
+    QThread::msleep(kTickMs);
+  }
+}
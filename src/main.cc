@@ -5,9 +5,11 @@
 #include "core/streams/panda_stream.h"
 #include "core/streams/replay_stream.h"
 #include "core/streams/socket_can_stream.h"
+#include "core/streams/synthetic_stream.h"
 #include "mainwin.h"
 #include "modules/settings/settings.h"
 #include "utils/system_signal_handler.h"
+#include "utils/trace.h"
 #include "utils/util.h"
 
 static AbstractStream* createStream(QCommandLineParser& p, QApplication* app) {
@@ -22,7 +24,25 @@ static AbstractStream* createStream(QCommandLineParser& p, QApplication* app) {
     }
   }
 
-  if (SocketCanStream::available() && p.isSet("socketcan")) return new SocketCanStream(app, {p.value("socketcan")});
+  if (SocketCanStream::available() && p.isSet("socketcan")) {
+    try {
+      return new SocketCanStream(app, {p.value("socketcan").split(',', Qt::SkipEmptyParts)});
+    } catch (const std::exception& e) {
+      qWarning() << e.what();
+      return nullptr;
+    }
+  }
+
+  if (p.isSet("synthetic")) {
+    try {
+      return new SyntheticStream(app, {.dbc_file = p.value("dbc"),
+                                       .rate = p.value("synthetic").toInt(),
+                                       .buses = p.value("synthetic-buses").toInt()});
+    } catch (const std::exception& e) {
+      qWarning() << e.what();
+      return nullptr;
+    }
+  }
 
   QString route = p.positionalArguments().value(0, p.isSet("demo") ? DEMO_ROUTE : "");
   if (!route.isEmpty()) {
@@ -67,19 +87,26 @@ int main(int argc, char* argv[]) {
       {{"zmq", "z"}, "read can messages from zmq at the specified ip-address", "ip-address"},
       {{"data_dir", "d"}, "local directory with routes", "data_dir"},
       {"no-vipc", "do not output video"},
-      {{"dbc", "b"}, "dbc file to open", "dbc"}
+      {{"dbc", "b"}, "dbc file to open", "dbc"},
+      {"synthetic", "generate CAN traffic at the given frames per second, from --dbc if given", "rate"},
+      {"synthetic-buses", "number of buses to generate on. Default: 1", "buses", "1"},
+      {"trace", "record a Chrome trace of the session and write it to file on exit", "file"}
   });
 
   if (SocketCanStream::available()) {
-    parser.addOption({"socketcan", "read can messages from given SocketCAN device", "socketcan"});
+    parser.addOption({"socketcan", "read can messages from given SocketCAN device(s), comma separated", "socketcan"});
   }
 
   parser.process(app);
 
+  trace::setThreadName("GUI");
+  if (parser.isSet("trace")) trace::start();
+
   AbstractStream* stream = createStream(parser, &app);
   {
     MainWindow w(stream, parser.value("dbc"));
     app.exec();
   }
+  if (parser.isSet("trace") && trace::isRecording()) trace::stop(parser.value("trace"));
   return 0;
 }
@@ -16,10 +16,13 @@
 #include "modules/dbc/export.h"
 #include "modules/settings/settings_dialog.h"
 #include "modules/streams/stream_selector.h"
+#include "modules/system/perf_panel.h"
 #include "modules/system/stream_manager.h"
 #include "modules/system/system_relay.h"
 #include "replay/include/http.h"
 #include "tools/findsignal.h"
+#include "tools/memoryusage.h"
+#include "utils/trace.h"
 #include "widgets/guide_overlay.h"
 
 MainWindow::MainWindow(AbstractStream* stream, const QString& dbc_file) : QMainWindow() {
@@ -138,6 +141,7 @@ void MainWindow::createViewMenu() {
   view_menu->addSeparator();
   view_menu->addAction(messages_dock_->toggleViewAction());
   view_menu->addAction(video_dock_->toggleViewAction());
+  view_menu->addAction(perf_dock_->toggleViewAction());
   view_menu->addSeparator();
   view_menu->addAction(tr("Reset Window Layout"), [this]() { restoreState(default_window_state_); });
 }
@@ -146,6 +150,13 @@ void MainWindow::createToolsMenu() {
   tools_menu_ = menuBar()->addMenu(tr("&Tools"));
   tools_menu_->addAction(tr("Find &Similar Bits"), this, &MainWindow::findSimilarBits);
   tools_menu_->addAction(tr("&Find Signal"), this, &MainWindow::findSignal);
+  tools_menu_->addSeparator();
+  tools_menu_->addAction(tr("&Memory Usage..."), this, &MainWindow::showMemoryUsage);
+  auto* trace_act = tools_menu_->addAction(tr("Record &Trace"));
+  trace_act->setCheckable(true);
+  trace_act->setChecked(trace::isRecording());
+  trace_act->setToolTip(tr("Record the pipeline stages, and save them as a Chrome trace when stopped"));
+  connect(trace_act, &QAction::toggled, this, &MainWindow::toggleTrace);
 }
 
 void MainWindow::createHelpMenu() {
@@ -157,6 +168,7 @@ void MainWindow::createHelpMenu() {
 void MainWindow::setupDocks() {
   createMessagesDock();
   createVideoChartsDock();
+  createPerfDock();
 }
 
 void MainWindow::createMessagesDock() {
@@ -203,11 +215,45 @@ void MainWindow::createVideoChartsDock() {
   connect(charts_panel, &ChartsPanel::showCursor, video_player_, &VideoPlayer::showThumbnail);
 }
 
+// Hidden by default; instrumentation only runs while it is shown
+void MainWindow::createPerfDock() {
+  perf_dock_ = new QDockWidget(tr("PERFORMANCE"), this);
+  perf_dock_->setObjectName("PerfPanel");
+  perf_dock_->setFeatures(QDockWidget::DockWidgetMovable | QDockWidget::DockWidgetFloatable |
+                          QDockWidget::DockWidgetClosable);
+  perf_dock_->setWidget(new PerfPanel(this));
+  addDockWidget(Qt::BottomDockWidgetArea, perf_dock_);
+  perf_dock_->hide();
+}
+
 void MainWindow::createShortcuts() {
   auto shortcut = new QShortcut(QKeySequence(Qt::Key_Space), this, nullptr, nullptr, Qt::ApplicationShortcut);
-  connect(shortcut, &QShortcut::activated, this,
-          []() { StreamManager::stream()->pause(!StreamManager::stream()->isPaused()); });
-  // TODO: add more shortcuts here.
+  connect(shortcut, &QShortcut::activated, this, []() {
+    auto* stream = StreamManager::stream();
+    if (stream->isPlayingReverse()) {
+      stream->playReverse(false);
+    } else {
+      stream->pause(!stream->isPaused());
+    }
+  });
+
+  auto add_shortcut = [this](const QKeySequence& key, std::function<void()> func) {
+    auto* s = new QShortcut(key, this, nullptr, nullptr, Qt::ApplicationShortcut);
+    connect(s, &QShortcut::activated, this, func);
+  };
+  add_shortcut(QKeySequence(Qt::SHIFT | Qt::Key_Space), []() {
+    auto* stream = StreamManager::stream();
+    stream->playReverse(!stream->isPlayingReverse());
+  });
+  // Step one frame of any message, or of the message open in the inspector
+  add_shortcut(QKeySequence(Qt::Key_Period), []() { StreamManager::stream()->stepFrame(1); });
+  add_shortcut(QKeySequence(Qt::Key_Comma), []() { StreamManager::stream()->stepFrame(-1); });
+  add_shortcut(QKeySequence(Qt::Key_BracketRight), [this]() {
+    if (auto id = inspector_widget_->currentMessage()) StreamManager::stream()->stepFrame(1, id);
+  });
+  add_shortcut(QKeySequence(Qt::Key_BracketLeft), [this]() {
+    if (auto id = inspector_widget_->currentMessage()) StreamManager::stream()->stepFrame(-1, id);
+  });
 }
 
 void MainWindow::onStreamChanged() {
@@ -388,6 +434,26 @@ void MainWindow::findSignal() {
   dlg->show();
 }
 
+void MainWindow::showMemoryUsage() {
+  auto* dlg = new MemoryUsageDlg(this);
+  dlg->setAttribute(Qt::WA_DeleteOnClose);
+  dlg->show();
+}
+
+void MainWindow::toggleTrace(bool record) {
+  if (record) {
+    trace::start();
+    return;
+  }
+
+  // Open with chrome://tracing or ui.perfetto.dev
+  QString fn = QFileDialog::getSaveFileName(this, tr("Save Trace"), settings.last_dir + "/cabana-trace.json",
+                                            tr("Chrome Trace (*.json)"));
+  if (!trace::stop(fn)) {
+    QMessageBox::warning(this, tr("Save Trace"), tr("Failed to write %1").arg(fn));
+  }
+}
+
 void MainWindow::onlineHelp() {
   if (auto guide = findChild<GuideOverlay*>()) {
     guide->close();
@@ -46,6 +46,7 @@ class MainWindow : public QMainWindow {
   void setupDocks();
   void createMessagesDock();
   void createVideoChartsDock();
+  void createPerfDock();
 
   void createLoadingDialog(bool is_live);
   void createShortcuts();
@@ -54,6 +55,8 @@ class MainWindow : public QMainWindow {
   void setOption();
   void findSimilarBits();
   void findSignal();
+  void showMemoryUsage();
+  void toggleTrace(bool record);
   void undoStackCleanChanged(bool clean);
   void onlineHelp();
   void toggleFullScreen();
@@ -64,6 +67,7 @@ class MainWindow : public QMainWindow {
   VideoPlayer* video_player_ = nullptr;
   QDockWidget* video_dock_ = nullptr;
   QDockWidget* messages_dock_ = nullptr;
+  QDockWidget* perf_dock_ = nullptr;
   MessageList* message_list_ = nullptr;
   MessageInspector* inspector_widget_ = nullptr;
   QWidget* floating_window_ = nullptr;
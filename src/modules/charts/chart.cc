@@ -22,6 +22,8 @@ Chart::Chart(QChartView* parent) : parent_(parent), QChart() {
   axis_y_ = new QValueAxis(this);
   addAxis(axis_x_, Qt::AlignBottom);
   addAxis(axis_y_, Qt::AlignLeft);
+  raster_item_ = new RasterSeriesItem(this);
+  raster_item_->setVisible(false);
 
   initControls();
   setupConnections();
@@ -30,15 +32,18 @@ Chart::Chart(QChartView* parent) : parent_(parent), QChart() {
 void Chart::setupConnections() {
   connect(axis_x_, &QValueAxis::rangeChanged, this, &Chart::updateAxisY);
   connect(axis_x_, &QValueAxis::rangeChanged, this, &Chart::updateSeriesPoints);
+  connect(axis_x_, &QValueAxis::rangeChanged, this, [this]() { updateVisiblePoints(); });
   connect(axis_x_, &QValueAxis::rangeChanged, this, &Chart::resetCache);
   connect(axis_y_, &QValueAxis::rangeChanged, this, &Chart::resetCache);
   connect(axis_y_, &QAbstractAxis::titleTextChanged, this, &Chart::resetCache);
+  connect(this, &QChart::plotAreaChanged, this, [this](const QRectF& rect) { raster_item_->setPlotArea(rect); });
 }
 
 void Chart::syncUI() {
   updateAxisY();
   updateTitle();
   updateSeriesPoints();
+  raster_item_->update();
   emit resetCache();
 }
 
@@ -56,7 +61,7 @@ void Chart::initControls() {
   // series types
   auto change_series_group = new QActionGroup(menu_);
   change_series_group->setExclusive(true);
-  QStringList types{tr("Line"), tr("Step Line"), tr("Scatter")};
+  QStringList types{tr("Line"), tr("Step Line"), tr("Scatter"), tr("Raster")};
   for (int i = 0; i < types.size(); ++i) {
     QAction* act = new QAction(types[i], change_series_group);
     act->setData(i);
@@ -119,9 +124,11 @@ void Chart::takeSignals(std::vector<ChartSignal>&& source_sigs) {
       old_chart->removeSeries(s.series);
     }
     attachSeries(s.series);
+    s.clearSeries();
   }
 
   std::move(source_sigs.begin(), source_sigs.end(), std::back_inserter(sigs_));
+  updateVisiblePoints();
   syncUI();
 }
 
@@ -155,6 +162,7 @@ void Chart::resizeEvent(QGraphicsSceneResizeEvent* event) {
   int x = close_btn_proxy_->pos().x() - manage_btn_proxy_->size().width() -
           style()->pixelMetric(QStyle::PM_ToolBarItemSpacing);
   manage_btn_proxy_->setPos(x, top);
+  updateVisiblePoints();
 
   if (align_to_ > 0) {
     alignLayout(align_to_, true);
@@ -327,16 +335,24 @@ void Chart::updateSeriesPoints() {
 
 void Chart::setSeriesType(SeriesType type) {
   if (type != series_type) {
+    // Line and step line share a QLineSeries, only the points handed to it differ
+    auto is_line = [](SeriesType t) { return t == SeriesType::Line || t == SeriesType::StepLine; };
+    const bool recreate = !is_line(type) || !is_line(series_type);
     series_type = type;
-    for (auto& s : sigs_) {
-      removeSeries(s.series);
-      s.series->deleteLater();
-    }
-    for (auto& s : sigs_) {
-      s.series = createSeries(series_type, s.sig->color);
-      const auto& points = series_type == SeriesType::StepLine ? s.step_vals : s.vals;
-      s.series->replace(QVector<QPointF>(points.cbegin(), points.cend()));
+    if (recreate) {
+      for (auto& s : sigs_) {
+        removeSeries(s.series);
+        s.series->deleteLater();
+      }
+      for (auto& s : sigs_) {
+        s.series = createSeries(series_type, s.sig->color);
+        s.clearSeries();
+      }
+    } else {
+      legend()->setMarkerShape(type == SeriesType::Line ? QLegend::MarkerShapeRectangle
+                                                        : QLegend::MarkerShapeFromSeries);
     }
+    updateVisiblePoints();
     syncUI();
 
     menu_->actions()[(int)type]->setChecked(true);
@@ -345,7 +361,8 @@ void Chart::setSeriesType(SeriesType type) {
 
 QXYSeries* Chart::createSeries(SeriesType type, QColor color) {
   QXYSeries* series = nullptr;
-  if (type == SeriesType::Line) {
+  if (type == SeriesType::Line || type == SeriesType::Raster) {
+    // Raster series stay empty, they only carry the color, pen and legend entry for RasterSeriesItem
     series = new QLineSeries(this);
     legend()->setMarkerShape(QLegend::MarkerShapeRectangle);
   } else if (type == SeriesType::StepLine) {
@@ -361,7 +378,7 @@ QXYSeries* Chart::createSeries(SeriesType type, QColor color) {
   // TODO: Due to a bug in CameraWidget the camera frames
   // are drawn instead of the graphs on MacOS. Re-enable OpenGL when fixed
 #ifndef __APPLE__
-  series->setUseOpenGL(true);
+  series->setUseOpenGL(type != SeriesType::Raster);
   QPen pen = series->pen();
   pen.setWidthF(2.0);
   series->setPen(pen);
@@ -414,13 +431,30 @@ void Chart::prepareData(const dbc::Signal* sig, const MessageEventsMap* msg_new_
 }
 
 void Chart::updateSeries(const dbc::Signal* sig) {
+  updateVisiblePoints(sig);
+  updateAxisY();
+  resetCache();
+}
+
+void Chart::updateVisiblePoints(const dbc::Signal* sig) {
+  raster_item_->setVisible(series_type == SeriesType::Raster);
+  if (series_type == SeriesType::Raster) {
+    for (auto& s : sigs_) {
+      if (!sig || s.sig == sig) s.clearSeries();
+    }
+    raster_item_->update();
+    return;
+  }
+
+  // The plot area is empty until the first layout, assume a typical width until then
+  const int width = plotArea().width() > 0 ? plotArea().width() : 1000;
+  const double min_x = axis_x_->min();
+  const double max_x = axis_x_->max();
   for (auto& s : sigs_) {
     if (!sig || s.sig == sig) {
-      s.updateSeries(series_type);
+      s.updateSeries(series_type, min_x, max_x, width);
     }
   }
-  updateAxisY();
-  resetCache();
 }
 
 void Chart::handleSignalChange(const dbc::Signal* sig) {
@@ -8,6 +8,7 @@
 #include <QtCharts/QLegendMarker>
 
 #include "components/chart_signal.h"
+#include "components/raster_series.h"
 
 class Chart : public QChart {
   Q_OBJECT
@@ -51,6 +52,7 @@ class Chart : public QChart {
   void resizeEvent(QGraphicsSceneResizeEvent* event) override;
   void setSeriesColor(QXYSeries* series, QColor color);
   void updateSeriesPoints();
+  void updateVisiblePoints(const dbc::Signal* sig = nullptr);
   void updateAxisY();
   QXYSeries* createSeries(SeriesType type, QColor color);
   std::pair<double, double> calculateValueRange(QString& common_unit);
@@ -68,6 +70,7 @@ class Chart : public QChart {
 
  private:
   int align_to_ = 0;
+  RasterSeriesItem* raster_item_;
   QAction* split_chart_act_;
   QAction* dynamic_separator_;
   QGraphicsProxyWidget* close_btn_proxy_;
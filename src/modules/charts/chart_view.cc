@@ -20,6 +20,8 @@
 #include "charts_panel.h"
 #include "modules/settings/settings.h"
 #include "modules/system/stream_manager.h"
+#include "utils/perf.h"
+#include "utils/trace.h"
 
 // ChartAxisElement's padding is 4 (https://codebrowser.dev/qt6/qtcharts/src/charts/axis/chartaxiselement_p.h.html)
 const int AXIS_X_TOP_MARGIN = 4;
@@ -287,6 +289,8 @@ void ChartView::startAnimation() {
 }
 
 void ChartView::paintEvent(QPaintEvent* event) {
+  TRACE_SCOPE("ChartView::paintEvent");
+  perf::ScopedTimer perf_timer(perf::Timing::ChartPaint);
   // If live streaming, bypass the pixmap cache to ensure smooth real-time updates
   if (StreamManager::stream()->liveStreaming()) {
     QChartView::paintEvent(event);
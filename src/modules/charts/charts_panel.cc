@@ -9,6 +9,8 @@
 #include "components/charts_container.h"
 #include "modules/settings/settings.h"
 #include "modules/system/stream_manager.h"
+#include "utils/perf.h"
+#include "utils/trace.h"
 
 ChartsPanel::ChartsPanel(QWidget* parent) : QFrame(parent) {
   setFrameStyle(QFrame::StyledPanel | QFrame::Plain);
@@ -80,13 +82,19 @@ void ChartsPanel::setupConnections() {
 
 void ChartsPanel::eventsMerged(const MessageEventsMap& new_events) {
   if (charts.empty()) return;
+  TRACE_SCOPE("ChartsPanel::eventsMerged");
+
+  {
+    perf::ScopedTimer perf_timer(perf::Timing::ChartPrepare);
+    QtConcurrent::blockingMap(charts, [&new_events](ChartView* c) {
+      if (c) {
+        TRACE_SCOPE("Chart::prepareData");
+        c->chart()->prepareData(nullptr, &new_events);
+      }
+    });
+  }
 
-  QtConcurrent::blockingMap(charts, [&new_events](ChartView* c) {
-    if (c) {
-      c->chart()->prepareData(nullptr, &new_events);
-    }
-  });
-
+  TRACE_SCOPE("Chart::updateSeries");
   for (auto* c : charts) {
     c->chart()->updateSeries(nullptr);
   }
@@ -1,22 +1,17 @@
 #include "chart_signal.h"
 
 #include "modules/system/stream_manager.h"
+#include "utils/perf.h"
 
 static void appendCanEvents(const dbc::Signal* sig, const std::vector<const CanEvent*>& events,
-                            std::vector<QPointF>& vals, std::vector<QPointF>& step_vals, SeriesBounds& series_bounds) {
+                            std::vector<QPointF>& vals) {
   vals.reserve(vals.size() + events.capacity());
-  step_vals.reserve(step_vals.size() + events.capacity() * 2);
 
   auto* can = StreamManager::stream();
   for (const CanEvent* e : events) {
     if (auto value = sig->parse(e->dat, e->size)) {
       const double ts = can->toSeconds(e->mono_ns);
       vals.emplace_back(ts, *value);
-
-      series_bounds.addPoint(*value);
-
-      if (!step_vals.empty()) step_vals.emplace_back(ts, step_vals.back().y());
-      step_vals.emplace_back(ts, *value);
     }
   }
 }
@@ -25,39 +20,106 @@ void ChartSignal::prepareData(const MessageEventsMap* msg_new_events, double min
   // If no new events provided, we are doing a full refresh/clear
   if (!msg_new_events) {
     vals.clear();
-    step_vals.clear();
     series_bounds.clear();
+    vals_lod_.clear();
+    shown_.series = nullptr;
+    last_range_ = {-1.0, -1.0};
+    ++data_version;
   }
 
   auto* can = StreamManager::stream();
   auto events = msg_new_events ? msg_new_events : &can->eventsMap();
   auto it = events->find(msg_id);
-  if (it == events->end() || it->second.empty()) return;
+  if (it == events->end() || it->second.empty()) {
+    updateMemoryUsage();
+    return;
+  }
 
-  if (vals.empty() || can->toSeconds(it->second.back()->mono_ns) > vals.back().x()) {
-    appendCanEvents(sig, it->second, vals, step_vals, series_bounds);
+  if (vals.empty() || can->toSeconds(it->second.front()->mono_ns) >= vals.back().x()) {
+    const size_t old_size = vals.size();
+    appendCanEvents(sig, it->second, vals);
+    // Fold the new points into the cached y-range, updateRange() only queries again if the x-range moved
+    for (size_t i = old_size; i < vals.size(); ++i) {
+      if (vals[i].x() >= last_range_.first && vals[i].x() < last_range_.second) {
+        min_value = std::min(min_value, vals[i].y());
+        max_value = std::max(max_value, vals[i].y());
+      }
+    }
   } else {
-    std::vector<QPointF> tmp_vals, tmp_step_vals;
-    appendCanEvents(sig, it->second, tmp_vals, tmp_step_vals, series_bounds);
+    std::vector<QPointF> tmp_vals;
+    appendCanEvents(sig, it->second, tmp_vals);
 
     auto insert_pos = std::ranges::lower_bound(vals, tmp_vals.front().x(), {}, &QPointF::x);
+    series_bounds.invalidateFrom(std::distance(vals.begin(), insert_pos));
     vals.insert(insert_pos, tmp_vals.begin(), tmp_vals.end());
 
-    auto step_insert_pos = std::ranges::lower_bound(step_vals, tmp_step_vals.front().x(), {}, &QPointF::x);
-    step_vals.insert(step_insert_pos, tmp_step_vals.begin(), tmp_step_vals.end());
-
-    // Rebuild the bounds cache to ensure hierarchy is correct after insertion
-    series_bounds.clear();
-    for (const auto& p : vals) series_bounds.addPoint(p.y());
+    vals_lod_.clear();
+    shown_.series = nullptr;
+    last_range_ = {-1.0, -1.0};
+    ++data_version;
   }
+  series_bounds.append(vals);
+  vals_lod_.append(vals);
 
-  last_range_ = {-1.0, -1.0};
   updateRange(min_x, max_x);
+  updateMemoryUsage();
+}
+
+void ChartSignal::updateMemoryUsage() {
+  vals_usage_.set(vals.capacity() * sizeof(QPointF));
+  bounds_usage_.set(series_bounds.memoryUsage());
+  lod_usage_.set(vals_lod_.memoryUsage());
+}
+
+// Step lines hold each value until the next sample: (x1, y0) is inserted before every (x1, y1)
+static void appendStep(QXYSeries* series, const QPointF& prev, const QPointF& pt) {
+  series->append(pt.x(), prev.y());
+  series->append(pt);
+}
+
+void ChartSignal::updateSeries(SeriesType series_type, double min_x, double max_x, int width) {
+  perf::ScopedTimer perf_timer(perf::Timing::ChartReplace);
+  const bool step = series_type == SeriesType::StepLine;
+  const auto [begin, end] = LodPyramid::visibleRange(vals, vals.size(), min_x, max_x);
+  const bool raw = !LodPyramid::isDecimated(end - begin, width);
+
+  // While raw points are shown and the data only grew, slide the window instead of replacing it all
+  const bool extends_shown = shown_.raw && shown_.series == series && shown_.type == series_type &&
+                             begin >= shown_.begin && begin <= shown_.end && end >= shown_.end;
+  if (raw && extends_shown && (begin - shown_.begin) + (end - shown_.end) <= kMaxIncrementalPoints) {
+    if (begin > shown_.begin) {
+      series->removePoints(0, std::min<int>((begin - shown_.begin) * (step ? 2 : 1), series->count()));
+    }
+    for (size_t i = shown_.end; i < end; ++i) {
+      if (step && i > begin) {
+        appendStep(series, vals[i - 1], vals[i]);
+      } else {
+        series->append(vals[i]);
+      }
+    }
+  } else {
+    QList<QPointF> points;
+    vals_lod_.visiblePoints(vals, min_x, max_x, width, points);
+    if (step && points.size() > 1) {
+      QList<QPointF> steps;
+      steps.reserve(points.size() * 2 - 1);
+      steps.push_back(points.front());
+      for (int i = 1; i < points.size(); ++i) {
+        steps.push_back({points[i].x(), points[i - 1].y()});
+        steps.push_back(points[i]);
+      }
+      points.swap(steps);
+    }
+    series->replace(points);
+  }
+  shown_ = {series, series_type, raw, begin, end};
+  series_usage_.set(series->count() * sizeof(QPointF));
 }
 
-void ChartSignal::updateSeries(SeriesType series_type) {
-  const auto& points = series_type == SeriesType::StepLine ? step_vals : vals;
-  series->replace(QList<QPointF>(points.begin(), points.end()));
+void ChartSignal::clearSeries() {
+  if (series->count() > 0) series->clear();
+  shown_ = {};
+  series_usage_.set(0);
 }
 
 void ChartSignal::updateRange(double min_x, double max_x) {
@@ -79,8 +141,7 @@ void ChartSignal::updateRange(double min_x, double max_x) {
   int r_idx = std::ranges::distance(vals.begin(), last) - 1;
 
   if (l_idx <= r_idx) {
-    // Hierarchical query is O(log N) for both Live and Log data
-    auto node = series_bounds.query(l_idx, r_idx, vals);
+    auto node = series_bounds.query(vals, l_idx, r_idx);
     min_value = node.min;
     max_value = node.max;
   }
@@ -6,13 +6,14 @@
 
 #include "core/dbc/dbc_manager.h"
 #include "core/streams/abstract_stream.h"
-#include "utils/segment_tree.h"
-#include "utils/series_bounds.h"
+#include "utils/lod_pyramid.h"
+#include "utils/mem_usage.h"
+#include "utils/range_minmax.h"
 
 // Define a small value of epsilon to compare double values
 const float EPSILON = 0.000001;
 
-enum class SeriesType { Line = 0, StepLine, Scatter };
+enum class SeriesType { Line = 0, StepLine, Scatter, Raster };
 
 class ChartSignal {
  public:
@@ -20,21 +21,46 @@ class ChartSignal {
   const dbc::Signal* sig = nullptr;
   QXYSeries* series = nullptr;
   std::vector<QPointF> vals;
-  std::vector<QPointF> step_vals;
   QPointF track_pt{};
   double min_value = 0;
   double max_value = 0;
+  int data_version = 0;  // Bumped whenever existing values change rather than new ones being appended
 
 
   ChartSignal(const MessageId& id, const dbc::Signal* s, QXYSeries* ser) : msg_id(id), sig(s), series(ser) {}
   void prepareData(const MessageEventsMap* msg_new_events, double min_x, double max_x);
   void updateRange(double main_x, double max_x);
-  void updateSeries(SeriesType series_type);
+  // Hands the series only the points needed to draw [min_x, max_x] at `width` pixels
+  void updateSeries(SeriesType series_type, double min_x, double max_x, int width);
+  // Empties the series and forgets what it showed. For a series that was replaced, moved to another
+  // chart or is left to the raster renderer.
+  void clearSeries();
   void updatePointsVisible(double sec_per_px);
+  void visiblePoints(double min_x, double max_x, int width, QList<QPointF>& out) const {
+    vals_lod_.visiblePoints(vals, min_x, max_x, width, out);
+  }
 
  private:
-  SeriesBounds series_bounds;
+  void updateMemoryUsage();
+
+  // QXYSeries emits a signal per appended or removed point, larger changes are cheaper as a replace
+  static constexpr size_t kMaxIncrementalPoints = 32;
+
+  // What the series holds, so new points can be appended to it instead of replacing everything
+  struct SeriesContent {
+    QXYSeries* series = nullptr;  // Reset whenever existing points move or change
+    SeriesType type = SeriesType::Line;
+    bool raw = false;
+    size_t begin = 0, end = 0;  // Range of vals shown when raw
+  } shown_;
+
+  RangeMinMax series_bounds;
+  LodPyramid vals_lod_;
   std::pair<double, double> last_range_{0, 0};
+  mem::Usage vals_usage_{mem::Pool::ChartValues};
+  mem::Usage bounds_usage_{mem::Pool::ChartMinMax};
+  mem::Usage lod_usage_{mem::Pool::ChartLod};
+  mem::Usage series_usage_{mem::Pool::ChartSeries};
 };
 
 qreal niceNumber(qreal x, bool ceiling);
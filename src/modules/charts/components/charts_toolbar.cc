@@ -80,6 +80,7 @@ void ChartsToolBar::createTypeMenu() {
       ChartStyle{tr("Line"), "chart-line"},
       ChartStyle{tr("Step"), "chart-network"},
       ChartStyle{tr("Scatter"), "chart-scatter"},
+      ChartStyle{tr("Raster"), "chart-area"},
   };
 
   for (int i = 0; i < styles.size(); ++i) {
@@ -0,0 +1,114 @@
+#include "raster_series.h"
+
+#include <QPainter>
+#include <cmath>
+
+#include "modules/charts/chart.h"
+
+RasterSeriesItem::RasterSeriesItem(Chart* chart) : QGraphicsItem(chart), chart_(chart) {
+  setZValue(4);  // Above the grid, like the QtCharts series items
+  setFlag(QGraphicsItem::ItemClipsToShape);
+}
+
+QRectF RasterSeriesItem::boundingRect() const { return rect_; }
+
+void RasterSeriesItem::setPlotArea(const QRectF& rect) {
+  prepareGeometryChange();
+  rect_ = rect;
+}
+
+RasterSeriesItem::Layout RasterSeriesItem::currentLayout(double sec_per_px, qreal dpr) const {
+  Layout layout;
+  // Keep the tile scale across tiny floating point changes while the view scrolls with live data
+  const bool same_zoom = std::abs(sec_per_px - layout_.sec_per_px) <= layout_.sec_per_px * 1e-6;
+  layout.sec_per_px = same_zoom ? layout_.sec_per_px : sec_per_px;
+  layout.min_y = chart_->axis_y_->min();
+  layout.max_y = chart_->axis_y_->max();
+  layout.height = rect_.height();
+  layout.dpr = dpr;
+  for (const auto& s : chart_->sigs_) {
+    if (s.series->isVisible()) layout.shown.emplace_back(s.sig, s.series->color().rgba());
+  }
+  return layout;
+}
+
+void RasterSeriesItem::paint(QPainter* painter, const QStyleOptionGraphicsItem*, QWidget*) {
+  if (rect_.isEmpty()) return;
+  const double min_x = chart_->axis_x_->min();
+  const double sec_per_px = (chart_->axis_x_->max() - min_x) / rect_.width();
+  if (sec_per_px <= 0) return;
+
+  Layout layout = currentLayout(sec_per_px, painter->device()->devicePixelRatioF());
+  if (!(layout == layout_)) {
+    tiles_.clear();
+    layout_ = std::move(layout);
+  }
+
+  const double tile_span = kTileWidth * layout_.sec_per_px;
+  const int64_t first = std::floor(min_x / tile_span);
+  const int64_t last = std::floor(chart_->axis_x_->max() / tile_span);
+  for (int64_t i = first; i <= last; ++i) {
+    Tile& tile = tiles_[i];
+    if (!isCurrent(tile, i)) renderTile(tile, i);
+    const QRectF target(rect_.left() + (i * tile_span - min_x) / sec_per_px, rect_.top(), tile_span / sec_per_px,
+                        rect_.height());
+    painter->drawImage(target, tile.image);
+  }
+  evictTiles(first, last);
+}
+
+bool RasterSeriesItem::isCurrent(const Tile& tile, int64_t index) const {
+  if (tile.image.isNull()) return false;
+
+  const double tile_end = (index + 1) * kTileWidth * layout_.sec_per_px;
+  size_t i = 0;
+  for (const auto& s : chart_->sigs_) {
+    if (!s.series->isVisible()) continue;
+    const SignalState& drawn = tile.drawn[i++];
+    if (drawn.data_version != s.data_version) return false;
+    // Points appended past the tile don't change it once it holds the line leading out of it
+    if (drawn.count != s.vals.size() && (drawn.count == 0 || s.vals[drawn.count - 1].x() <= tile_end)) return false;
+  }
+  return true;
+}
+
+void RasterSeriesItem::renderTile(Tile& tile, int64_t index) {
+  tile.image = QImage(QSize(kTileWidth, layout_.height) * layout_.dpr, QImage::Format_ARGB32_Premultiplied);
+  tile.image.setDevicePixelRatio(layout_.dpr);
+  tile.image.fill(Qt::transparent);
+  tile.drawn.clear();
+
+  const double x0 = index * kTileWidth * layout_.sec_per_px;
+  const double x1 = x0 + kTileWidth * layout_.sec_per_px;
+  const double y_scale = layout_.max_y > layout_.min_y ? layout_.height / (layout_.max_y - layout_.min_y) : 0;
+
+  QPainter p(&tile.image);
+  p.setRenderHint(QPainter::Antialiasing);
+  QList<QPointF> points;
+  QPolygonF line;
+  for (const auto& s : chart_->sigs_) {
+    if (!s.series->isVisible()) continue;
+    tile.drawn.push_back({s.data_version, s.vals.size()});
+
+    s.visiblePoints(x0, x1, kTileWidth, points);
+    line.resize(points.size());
+    for (int i = 0; i < points.size(); ++i) {
+      line[i] = {(points[i].x() - x0) / layout_.sec_per_px, layout_.height - (points[i].y() - layout_.min_y) * y_scale};
+    }
+    p.setPen(s.series->pen());
+    p.drawPolyline(line);
+  }
+}
+
+void RasterSeriesItem::evictTiles(int64_t first, int64_t last) {
+  // Drop whichever end of the cache is farther from the view
+  while (tiles_.size() > kMaxTiles) {
+    auto front = tiles_.begin();
+    auto back = std::prev(tiles_.end());
+    if (first - front->first > back->first - last) {
+      tiles_.erase(front);
+    } else {
+      tiles_.erase(back);
+    }
+  }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <QColor>
+#include <QGraphicsItem>
+#include <QImage>
+#include <map>
+#include <vector>
+
+class Chart;
+namespace dbc {
+class Signal;
+}
+
+// Software renderer for the Raster series type. Curves are drawn with QPainter from the
+// downsampled points of each signal into tiles of a fixed time span, so panning only renders
+// the tiles that scroll into view and live data only redraws the last tile. Tiles are dropped
+// when the zoom, y-range, plot height or the set of shown signals changes.
+class RasterSeriesItem : public QGraphicsItem {
+ public:
+  explicit RasterSeriesItem(Chart* chart);
+  QRectF boundingRect() const override;
+  void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) override;
+  void setPlotArea(const QRectF& rect);
+
+ private:
+  friend class TestRasterSeries;
+
+  // Per signal: the data a tile was drawn from
+  struct SignalState {
+    int data_version;
+    size_t count;
+  };
+  struct Tile {
+    QImage image;
+    std::vector<SignalState> drawn;  // In the order of Layout::shown
+  };
+  // What every tile depends on apart from the data
+  struct Layout {
+    double sec_per_px = 0;
+    double min_y = 0, max_y = 0;
+    int height = 0;
+    qreal dpr = 0;
+    std::vector<std::pair<const dbc::Signal*, QRgb>> shown;  // Visible signals and their colors
+    bool operator==(const Layout& other) const = default;
+  };
+
+  static constexpr int kTileWidth = 256;  // Logical pixels
+  static constexpr size_t kMaxTiles = 64;
+
+  Layout currentLayout(double sec_per_px, qreal dpr) const;
+  bool isCurrent(const Tile& tile, int64_t index) const;
+  void renderTile(Tile& tile, int64_t index);
+  void evictTiles(int64_t first, int64_t last);
+
+  Chart* chart_;
+  QRectF rect_;
+  Layout layout_;
+  std::map<int64_t, Tile> tiles_;  // By tile index, tile i starts at i * kTileWidth * sec_per_px
+};
@@ -41,6 +41,8 @@ void Sparkline::update(const dbc::Signal* sig, CanEventIter first, CanEventIter
     mapHistoryToPoints();
     render();
   }
+  usage_.set(sizeof(Sparkline) + render_pts_.capacity() * sizeof(QPointF) + history_bounds_.memoryUsage() +
+             image_.sizeInBytes());
 }
 
 void Sparkline::updateDataPoints(const dbc::Signal* sig, CanEventIter first, CanEventIter last) {
@@ -51,9 +53,9 @@ void Sparkline::updateDataPoints(const dbc::Signal* sig, CanEventIter first, Can
   for (; it != last; ++it) {
     auto* e = *it;
     if (auto val = sig->parse(e->dat, e->size)) {
+      // A full ring buffer overwrites its oldest point
+      if (history_.size() == history_.capacity()) history_bounds_.dropFront(1);
       history_.push_back({e->mono_ns, *val});
-      if (*val < min_val_) min_val_ = *val;
-      if (*val > max_val_) max_val_ = *val;
     }
   }
 
@@ -65,8 +67,9 @@ void Sparkline::updateDataPoints(const dbc::Signal* sig, CanEventIter first, Can
   }
   if (purge_count > 0) {
     history_.pop_front_n(purge_count);
-    bounds_dirty_ = true;  // Purged points may have held min/max
+    history_bounds_.dropFront(purge_count);
   }
+  history_bounds_.append(history_);
 }
 
 void Sparkline::mapHistoryToPoints() {
@@ -204,33 +207,18 @@ void Sparkline::render() {
 }
 
 void Sparkline::updateValueBounds() {
-  if (!bounds_dirty_) return;
-  bounds_dirty_ = false;
-
-  if (history_.empty()) {
-    min_val_ = std::numeric_limits<double>::max();
-    max_val_ = std::numeric_limits<double>::lowest();
-    return;
-  }
-
-  double lo = history_[0].value;
-  double hi = lo;
-  for (size_t i = 1; i < history_.size(); ++i) {
-    const double v = history_[i].value;
-    if (v < lo) lo = v;
-    if (v > hi) hi = v;
-  }
-  min_val_ = lo;
-  max_val_ = hi;
+  const MinMax bounds = history_bounds_.query(history_, 0, history_.size() - 1);
+  min_val_ = bounds.min;
+  max_val_ = bounds.max;
 }
 
 void Sparkline::clearHistory() {
   history_.clear();
+  history_bounds_.clear();
   render_pts_.clear();
   image_ = QImage();
   min_val_ = std::numeric_limits<double>::max();
   max_val_ = std::numeric_limits<double>::lowest();
-  bounds_dirty_ = false;
   last_processed_ns_ = 0;
 }
 
@@ -7,6 +7,8 @@
 
 #include "core/dbc/dbc_message.h"
 #include "core/streams/abstract_stream.h"
+#include "utils/mem_usage.h"
+#include "utils/range_minmax.h"
 
 // Size 32768 supports 30s of 1000Hz data
 template <typename T, size_t N = 32768>
@@ -31,6 +33,7 @@ class RingBuffer {
   }
   size_t size() const { return count; }
   bool empty() const { return count == 0; }
+  static constexpr size_t capacity() { return N; }
 
  private:
   std::array<T, N> buffer;
@@ -43,6 +46,7 @@ class Sparkline {
   struct DataPoint {
     uint64_t mono_ns;
     double value;
+    friend double minMaxValue(const DataPoint& pt) { return pt.value; }
   };
   void update(const dbc::Signal* sig, CanEventIter first, CanEventIter last,
               uint64_t current_ns, int time_window, const QSize& size);
@@ -100,12 +104,13 @@ class Sparkline {
   QSize widget_size_;
 
   RingBuffer<DataPoint> history_;
+  RangeMinMax history_bounds_;
   std::vector<QPointF> render_pts_;
-  bool bounds_dirty_ = true;
   bool is_highlighted_ = false;
   uint64_t last_processed_ns_ = 0;
   QColor signal_color_;
   QImage image_;
+  mem::Usage usage_{mem::Pool::Sparklines};
   double min_val_ = std::numeric_limits<double>::max();
   double max_val_ = std::numeric_limits<double>::lowest();
 };
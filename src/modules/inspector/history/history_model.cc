@@ -111,6 +111,7 @@ void MessageHistoryModel::updateState(bool clear) {
   fetchData(0, current_time, last_time);
 
   if (!is_paused) pruneToLiveLimit();
+  updateMemoryUsage();
 }
 
 bool MessageHistoryModel::canFetchMore(const QModelIndex& parent) const {
@@ -127,6 +128,12 @@ void MessageHistoryModel::fetchMore(const QModelIndex& parent) {
   if (messages.empty()) return;
   // Fetch older data at the end (Infinite Scroll)
   fetchData(static_cast<int>(messages.size()), messages.back().mono_ns, 0);
+  updateMemoryUsage();
+}
+
+// Rows and their signal values; deque blocks are not counted
+void MessageHistoryModel::updateMemoryUsage() {
+  usage_.set(messages.size() * (sizeof(LogEntry) + sigs.size() * sizeof(double)));
 }
 
 void MessageHistoryModel::pruneToLiveLimit() {
@@ -6,6 +6,7 @@
 
 #include "core/dbc/dbc_manager.h"
 #include "core/streams/message_state.h"
+#include "utils/mem_usage.h"
 
 class MessageHistoryModel : public QAbstractTableModel {
   Q_OBJECT
@@ -53,6 +54,8 @@ class MessageHistoryModel : public QAbstractTableModel {
   MessageId msg_id;
 
  private:
+  void updateMemoryUsage();
+
   MessageState hex_colors;
   const int batch_size = 50;
   int filter_sig_idx = -1;
@@ -62,4 +65,5 @@ class MessageHistoryModel : public QAbstractTableModel {
   std::vector<SignalColumn> sigs;
   bool hex_mode = false;
   bool is_paused = false;
+  mem::Usage usage_{mem::Pool::History};
 };
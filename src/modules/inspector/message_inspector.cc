@@ -15,6 +15,11 @@ void MessageInspector::setMessage(const MessageId& message_id) {
   message_view->setMessage(message_id);
 }
 
+std::optional<MessageId> MessageInspector::currentMessage() const {
+  if (currentWidget() != message_view) return std::nullopt;
+  return message_view->messageId();
+}
+
 void MessageInspector::clear() {
   message_view->resetState();
   if (currentWidget() != welcome_widget) {
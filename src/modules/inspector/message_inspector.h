@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QStackedWidget>
+#include <optional>
 
 #include "message_view.h"
 #include "welcome_widget.h"
@@ -11,6 +12,8 @@ class MessageInspector : public QStackedWidget {
  public:
   MessageInspector(ChartsPanel* charts, QWidget* parent);
   void setMessage(const MessageId& message_id);
+  // The message shown in the inspector, if any
+  std::optional<MessageId> currentMessage() const;
   MessageView* getMessageView() { return message_view; }
   void clear();
 
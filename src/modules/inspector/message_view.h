@@ -17,6 +17,7 @@ class MessageView : public QWidget {
  public:
   MessageView(ChartsPanel* charts, QWidget* parent);
   void setMessage(const MessageId& message_id);
+  inline const MessageId& messageId() const { return msg_id; }
   void refresh();
   std::pair<QString, QStringList> serializeMessageIds() const;
   void restoreTabs(const QString active_msg_id, const QStringList& msg_ids);
@@ -2,6 +2,7 @@
 
 #include "signal_editor.h"
 #include "signal_tree_delegate.h"
+#include "utils/trace.h"
 
 SignalTree::SignalTree(QWidget* parent) : QTreeView(parent) {
   setFrameShape(QFrame::NoFrame);
@@ -58,6 +59,7 @@ void SignalTree::updateHighlight(const dbc::Signal* sig) {
 }
 
 void SignalTree::paintEvent(QPaintEvent* event) {
+  TRACE_SCOPE("SignalTree::paintEvent");
   QTreeView::paintEvent(event);
 
   if (!model() || model()->rowCount(rootIndex()) > 0) return;
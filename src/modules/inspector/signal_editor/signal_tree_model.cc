@@ -11,6 +11,7 @@
 #include "modules/inspector/binary/binary_model.h"
 #include "modules/settings/settings.h"
 #include "modules/system/stream_manager.h"
+#include "utils/trace.h"
 
 static const QStringList SIGNAL_PROPERTY_LABELS = {
     "Name",   "Size", "Receiver Nodes",  "Little Endian", "Signed", "Offset",
@@ -115,7 +116,9 @@ void SignalTreeModel::updateSparklines(const MessageSnapshot* msg, int first_row
   uint64_t win_start = (current_ns > range_ns) ? (current_ns - range_ns) : 0;
   auto range = stream->eventsInRange(msg_id, std::make_pair(stream->toSeconds(win_start), stream->toSeconds(current_ns)));
 
+  TRACE_SCOPE("SignalTreeModel::updateSparklines");
   QtConcurrent::blockingMap(items, [&](SignalTreeModel::Item* item) {
+    TRACE_SCOPE("Sparkline::update");
     item->sparkline->update(item->sig, range.first, range.second, current_ns, settings.sparkline_range, size);
   });
 
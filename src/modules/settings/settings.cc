@@ -30,6 +30,8 @@ void settings_op(SettingOperation op) {
   op(s, "sparkline_range", settings.sparkline_range);
   op(s, "log_livestream", settings.log_livestream);
   op(s, "log_path", settings.log_path);
+  op(s, "log_compress", settings.log_compress);
+  op(s, "log_capture", settings.log_capture);
   op(s, "drag_direction", (int&)settings.drag_direction);
   op(s, "recent_dbc_file", settings.recent_dbc_file);
   op(s, "active_msg_id", settings.active_msg_id);
@@ -47,5 +49,6 @@ Settings::Settings() {
 }
 
 Settings::~Settings() {
+  if (!save_on_exit) return;
   settings_op([](QSettings& s, const QString& key, auto& v) { s.setValue(key, v); });
 }
@@ -22,6 +22,8 @@ class Settings : public QObject {
   Settings();
   ~Settings();
 
+  bool save_on_exit = true;  // Off for tools that share the GUI's settings but must not change them
+
   bool absolute_time = false;
   int fps = 10;
   int max_cached_minutes = 30;
@@ -32,6 +34,8 @@ class Settings : public QObject {
   int theme = 0;
   int sparkline_range = 15;  // 15 seconds
   bool log_livestream = true;
+  bool log_compress = false;  // Write rlog.zst instead of rlog
+  bool log_capture = false;   // Also record a Cabana capture (.ccap)
   QString log_path;
   QString last_dir;
   QString last_route_dir;
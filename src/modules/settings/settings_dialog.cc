@@ -53,11 +53,17 @@ SettingsDialog::SettingsDialog(QWidget* parent) : QDialog(parent) {
 
   log_livestream = new QGroupBox(tr("Enable live stream logging"), this);
   log_livestream->setCheckable(true);
-  QHBoxLayout* path_layout = new QHBoxLayout(log_livestream);
+  QVBoxLayout* log_layout = new QVBoxLayout(log_livestream);
+  QHBoxLayout* path_layout = new QHBoxLayout();
   path_layout->addWidget(log_path = new QLineEdit(settings.log_path, this));
   log_path->setReadOnly(true);
   auto browse_btn = new QPushButton(tr("B&rowse..."));
   path_layout->addWidget(browse_btn);
+  log_layout->addLayout(path_layout);
+  log_layout->addWidget(log_compress = new QCheckBox(tr("Compress segments with zstd (rlog.zst)"), this));
+  log_compress->setChecked(settings.log_compress);
+  log_layout->addWidget(log_capture = new QCheckBox(tr("Also record a Cabana capture (.ccap)"), this));
+  log_capture->setChecked(settings.log_capture);
   main_layout->addWidget(log_livestream);
 
   auto buttonBox = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
@@ -86,6 +92,8 @@ void SettingsDialog::save() {
   settings.chart_height = chart_height->value();
   settings.log_livestream = log_livestream->isChecked();
   settings.log_path = log_path->text();
+  settings.log_compress = log_compress->isChecked();
+  settings.log_capture = log_capture->isChecked();
   settings.drag_direction = (Settings::DragDirection)drag_direction->currentIndex();
   emit settings.changed();
   QDialog::accept();
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QCheckBox>
 #include <QComboBox>
 #include <QDialog>
 #include <QGroupBox>
@@ -17,5 +18,7 @@ class SettingsDialog : public QDialog {
   QComboBox* theme;
   QGroupBox* log_livestream;
   QLineEdit* log_path;
+  QCheckBox* log_compress;
+  QCheckBox* log_capture;
   QComboBox* drag_direction;
 };
@@ -0,0 +1,61 @@
+#include "capture.h"
+
+#include <QApplication>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QVBoxLayout>
+
+#include "core/streams/capture_stream.h"
+#include "modules/settings/settings.h"
+
+CaptureWidget::CaptureWidget(QWidget* parent) : AbstractStreamWidget(parent) {
+  QVBoxLayout* main_layout = new QVBoxLayout(this);
+  main_layout->addStretch(1);
+
+  QHBoxLayout* file_layout = new QHBoxLayout();
+  file_edit_ = new QLineEdit(this);
+  file_edit_->setReadOnly(true);
+  file_edit_->setPlaceholderText(tr("Select Cabana capture file(s) (.ccap)"));
+
+  QPushButton* browse_btn = new QPushButton(tr("Browse..."), this);
+  file_layout->addWidget(new QLabel(tr("Capture file(s)"), this));
+  file_layout->addWidget(file_edit_, 1);
+  file_layout->addWidget(browse_btn);
+  main_layout->addLayout(file_layout);
+
+  main_layout->addStretch(1);
+  setFocusProxy(file_edit_);
+  emit enableOpenButton(false);
+
+  connect(browse_btn, &QPushButton::clicked, this, [this]() {
+    // Live streams record their captures to the log directory
+    QStringList files = QFileDialog::getOpenFileNames(this, tr("Open Cabana Capture File(s)"), settings.log_path,
+                                                      tr("Cabana Captures (*.ccap);;All Files (*)"));
+    if (!files.isEmpty()) {
+      file_paths_ = files;
+      file_edit_->setText(files.size() == 1 ? files.first()
+                                            : tr("%1 files selected").arg(files.size()));
+      emit enableOpenButton(true);
+    }
+  });
+}
+
+AbstractStream* CaptureWidget::open() {
+  if (file_paths_.isEmpty()) {
+    QMessageBox::warning(this, tr("No file selected"), tr("Please select a Cabana capture."));
+    return nullptr;
+  }
+
+  auto* stream = new CaptureStream(qApp, file_paths_);
+  if (stream->maxSeconds() == 0) {
+    QMessageBox::warning(this, tr("Failed to open"),
+                         tr("Could not parse any CAN frames from the selected file(s).\n\n"
+                            "Ensure the files are captures recorded by a Cabana live stream."));
+    delete stream;
+    return nullptr;
+  }
+  return stream;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <QLineEdit>
+#include <QStringList>
+
+#include "abstract.h"
+
+class CaptureWidget : public AbstractStreamWidget {
+  Q_OBJECT
+
+ public:
+  CaptureWidget(QWidget* parent = nullptr);
+  AbstractStream* open() override;
+
+ private:
+  QLineEdit* file_edit_;
+  QStringList file_paths_;
+};
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <QLineEdit>
+#include <QStringList>
+
+#include "abstract.h"
+
+class PcapLogWidget : public AbstractStreamWidget {
+  Q_OBJECT
+
+ public:
+  PcapLogWidget(QWidget* parent = nullptr);
+  AbstractStream* open() override;
+
+ private:
+  QLineEdit* file_edit_;
+  QStringList file_paths_;
+};
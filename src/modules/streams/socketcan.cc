@@ -5,6 +5,7 @@
 #include <QHBoxLayout>
 #include <QMessageBox>
 #include <QPushButton>
+#include <QSignalBlocker>
 
 SocketCanWidget::SocketCanWidget(QWidget* parent) : AbstractStreamWidget(parent) {
   QVBoxLayout* main_layout = new QVBoxLayout(this);
@@ -13,30 +14,43 @@ SocketCanWidget::SocketCanWidget(QWidget* parent) : AbstractStreamWidget(parent)
   QFormLayout* form_layout = new QFormLayout();
 
   QHBoxLayout* device_layout = new QHBoxLayout();
-  device_edit = new QComboBox();
-  device_layout->addWidget(device_edit, 1);
+  device_list = new QListWidget();
+  device_list->setToolTip(tr("Each checked interface is captured as its own bus, in list order"));
+  device_layout->addWidget(device_list, 1);
 
   QPushButton* refresh = new QPushButton(tr("Refresh"));
-  device_layout->addWidget(refresh);
-  form_layout->addRow(tr("Device"), device_layout);
+  device_layout->addWidget(refresh, 0, Qt::AlignTop);
+  form_layout->addRow(tr("Devices"), device_layout);
   main_layout->addLayout(form_layout);
 
   main_layout->addStretch(1);
-  setFocusProxy(device_edit);
+  setFocusProxy(device_list);
 
   connect(refresh, &QPushButton::clicked, this, &SocketCanWidget::refreshDevices);
-  connect(device_edit, &QComboBox::currentTextChanged, this, [this](const QString& text) { config.device = text; });
+  connect(device_list, &QListWidget::itemChanged, this, &SocketCanWidget::updateSelection);
 
   refreshDevices();
 }
 
 void SocketCanWidget::refreshDevices() {
-  device_edit->clear();
-  for (auto& device : QCanBus::instance()->availableDevices(QStringLiteral("socketcan"))) {
-    device_edit->addItem(device.name());
+  QSignalBlocker blocker(device_list);
+  device_list->clear();
+  for (const QString& device : SocketCanStream::availableDevices()) {
+    auto* item = new QListWidgetItem(device, device_list);
+    item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+    item->setCheckState(device_list->count() == 1 ? Qt::Checked : Qt::Unchecked);
   }
-  config.device = device_edit->currentText();
-  emit enableOpenButton(!config.device.isEmpty());
+  updateSelection();
+}
+
+void SocketCanWidget::updateSelection() {
+  config.devices.clear();
+  for (int i = 0; i < device_list->count(); ++i) {
+    if (device_list->item(i)->checkState() == Qt::Checked) {
+      config.devices.push_back(device_list->item(i)->text());
+    }
+  }
+  emit enableOpenButton(!config.devices.isEmpty());
 }
 
 AbstractStream* SocketCanWidget::open() {
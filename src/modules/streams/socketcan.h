@@ -1,6 +1,6 @@
 #pragma once
 
-#include <QComboBox>
+#include <QListWidget>
 
 #include "abstract.h"
 #include "core/streams/socket_can_stream.h"
@@ -14,7 +14,8 @@ class SocketCanWidget : public AbstractStreamWidget {
 
  private:
   void refreshDevices();
+  void updateSelection();
 
-  QComboBox* device_edit;
+  QListWidget* device_list;
   SocketCanStreamConfig config = {};
 };
@@ -6,11 +6,16 @@
 
 #include "modules/settings/settings.h"
 #include "asc_log.h"
+#include "blf_log.h"
+#include "capture.h"
 #include "candump_log.h"
 #include "device.h"
+#include "mf4_log.h"
 #include "panda.h"
+#include "pcap_log.h"
 #include "route.h"
 #include "socketcan.h"
+#include "synthetic.h"
 #include "trc_log.h"
 
 StreamSelector::StreamSelector(QWidget* parent) : QDialog(parent) {
@@ -45,13 +50,18 @@ StreamSelector::StreamSelector(QWidget* parent) : QDialog(parent) {
 
   addStreamWidget(new RouteWidget, tr("&Route"));
   addStreamWidget(new AscLogWidget, tr("&ASC Log"));
+  addStreamWidget(new BlfLogWidget, tr("&BLF Log"));
   addStreamWidget(new CandumpLogWidget, tr("&candump"));
   addStreamWidget(new TrcLogWidget, tr("&TRC"));
+  addStreamWidget(new Mf4LogWidget, tr("&MF4"));
+  addStreamWidget(new PcapLogWidget, tr("pcap/pcap&ng"));
+  addStreamWidget(new CaptureWidget, tr("Capt&ure"));
   addStreamWidget(new PandaWidget, tr("&Panda"));
   if (SocketCanStream::available()) {
     addStreamWidget(new SocketCanWidget, tr("&SocketCAN"));
   }
   addStreamWidget(new DeviceWidget, tr("&Device"));
+  addStreamWidget(new SyntheticWidget, tr("S&ynthetic"));
 
   connect(btn_box, &QDialogButtonBox::rejected, this, &QDialog::reject);
   connect(btn_box, &QDialogButtonBox::accepted, [=]() {
@@ -0,0 +1,78 @@
+#include "synthetic.h"
+
+#include <QApplication>
+#include <QFileDialog>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QVBoxLayout>
+
+#include "modules/settings/settings.h"
+
+SyntheticWidget::SyntheticWidget(QWidget* parent) : AbstractStreamWidget(parent) {
+  QVBoxLayout* main_layout = new QVBoxLayout(this);
+  main_layout->addStretch(1);
+
+  QFormLayout* form_layout = new QFormLayout();
+  QHBoxLayout* dbc_layout = new QHBoxLayout();
+  dbc_edit = new QLineEdit(this);
+  dbc_edit->setReadOnly(true);
+  dbc_edit->setClearButtonEnabled(true);
+  dbc_edit->setPlaceholderText(tr("Built-in message set"));
+  QPushButton* browse_btn = new QPushButton(tr("Browse..."), this);
+  dbc_layout->addWidget(dbc_edit, 1);
+  dbc_layout->addWidget(browse_btn);
+  form_layout->addRow(tr("Generate from"), dbc_layout);
+
+  rate = new QSpinBox(this);
+  rate->setRange(1, 1000000);
+  rate->setSingleStep(1000);
+  rate->setValue(10000);
+  rate->setSuffix(tr(" frames/s"));
+  rate->setToolTip(tr("Total rate across all buses. Every message is sent at the same period."));
+  form_layout->addRow(tr("Rate"), rate);
+
+  buses = new QSpinBox(this);
+  buses->setRange(1, 16);
+  buses->setToolTip(tr("Every message is sent on each bus"));
+  form_layout->addRow(tr("Buses"), buses);
+
+  messages = new QSpinBox(this);
+  messages->setRange(1, 1024);
+  messages->setValue(64);
+  form_layout->addRow(tr("Messages"), messages);
+
+  can_fd = new QCheckBox(tr("64-byte CAN FD frames"), this);
+  form_layout->addRow(QString(), can_fd);
+  main_layout->addLayout(form_layout);
+
+  main_layout->addStretch(1);
+  setFocusProxy(rate);
+
+  connect(browse_btn, &QPushButton::clicked, this, [this]() {
+    QString fn = QFileDialog::getOpenFileName(this, tr("Open File"), settings.last_dir, "DBC (*.dbc)");
+    if (!fn.isEmpty()) dbc_edit->setText(fn);
+  });
+  // Message count and frame size only apply to the built-in set
+  connect(dbc_edit, &QLineEdit::textChanged, this, [this](const QString& text) {
+    messages->setEnabled(text.isEmpty());
+    can_fd->setEnabled(text.isEmpty());
+  });
+}
+
+AbstractStream* SyntheticWidget::open() {
+  SyntheticStreamConfig config = {
+      .dbc_file = dbc_edit->text(),
+      .rate = rate->value(),
+      .buses = buses->value(),
+      .messages = messages->value(),
+      .can_fd = can_fd->isChecked(),
+  };
+  try {
+    return new SyntheticStream(qApp, config);
+  } catch (std::exception& e) {
+    QMessageBox::warning(nullptr, tr("Warning"), tr("Failed to start synthetic stream: '%1'").arg(e.what()));
+    return nullptr;
+  }
+}
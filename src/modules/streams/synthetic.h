@@ -0,0 +1,23 @@
+#pragma once
+
+#include <QCheckBox>
+#include <QLineEdit>
+#include <QSpinBox>
+
+#include "abstract.h"
+#include "core/streams/synthetic_stream.h"
+
+class SyntheticWidget : public AbstractStreamWidget {
+  Q_OBJECT
+
+ public:
+  SyntheticWidget(QWidget* parent = nullptr);
+  AbstractStream* open() override;
+
+ private:
+  QLineEdit* dbc_edit;
+  QSpinBox* rate;
+  QSpinBox* buses;
+  QSpinBox* messages;
+  QCheckBox* can_fd;
+};
@@ -0,0 +1,186 @@
+#include "modules/system/perf_panel.h"
+
+#include <QFontDatabase>
+#include <QPainter>
+#include <QTimerEvent>
+#include <algorithm>
+#include <cmath>
+
+#include "modules/system/stream_manager.h"
+
+namespace {
+
+constexpr int kSampleMs = 1000;
+constexpr int kLagProbeMs = 50;
+constexpr size_t kWindowSeconds = 10;  // Span of the histograms
+constexpr size_t kRateHistory = 60;    // Span of the frame rate graph
+constexpr int kPadding = 6;
+constexpr int kGraphHeight = 32;
+constexpr int kBarWidth = 4;
+
+QString formatNs(double ns) {
+  if (ns < 1e6) return QString("%1 us").arg(ns / 1e3, 0, 'f', 0);
+  return QString("%1 ms").arg(ns / 1e6, 0, 'f', 1);
+}
+
+// Upper bound of the bucket holding the q-th quantile
+double percentileNs(const perf::Histogram& h, double q) {
+  if (h.count == 0) return 0;
+  const uint64_t target = std::max<uint64_t>(1, std::ceil(q * h.count));
+  uint64_t seen = 0;
+  for (int b = 0; b < perf::kBuckets; ++b) {
+    seen += h.buckets[b];
+    if (seen >= target) return perf::bucketLimitNs(b);
+  }
+  return perf::bucketLimitNs(perf::kBuckets - 1);
+}
+
+}  // namespace
+
+PerfPanel::PerfPanel(QWidget* parent) : QWidget(parent) {
+  QFont mono_font = QFontDatabase::systemFont(QFontDatabase::FixedFont);
+  mono_font.setPixelSize(12);
+  setFont(mono_font);
+  setToolTip(tr("Histograms cover the last %1 seconds, from 1us on the left doubling per bar").arg(kWindowSeconds));
+}
+
+QSize PerfPanel::sizeHint() const {
+  const int lh = fontMetrics().height() + kPadding;
+  const int rows = (int)perf::Timing::Count + 2 + stream_stats_.size();
+  return QSize(fontMetrics().horizontalAdvance(' ') * 52 + perf::kBuckets * kBarWidth + kPadding * 3,
+               kGraphHeight + rows * lh + kPadding * 3);
+}
+
+void PerfPanel::showEvent(QShowEvent* event) {
+  last_ = perf::snapshot();
+  window_.clear();
+  frame_rates_.clear();
+  perf::setEnabled(true);
+  sample_timer_.start(kSampleMs, this);
+  lag_timer_.start(kLagProbeMs, Qt::PreciseTimer, this);
+  lag_expected_ns_ = nanos_since_boot() + kLagProbeMs * 1'000'000ULL;
+  QWidget::showEvent(event);
+}
+
+void PerfPanel::hideEvent(QHideEvent* event) {
+  perf::setEnabled(false);
+  sample_timer_.stop();
+  lag_timer_.stop();
+  QWidget::hideEvent(event);
+}
+
+void PerfPanel::timerEvent(QTimerEvent* event) {
+  if (event->timerId() == lag_timer_.timerId()) {
+    // How late the timer fires is how long the event loop was busy with something else
+    const uint64_t now = nanos_since_boot();
+    perf::record(perf::Timing::EventLoopLag, now > lag_expected_ns_ ? now - lag_expected_ns_ : 0);
+    lag_expected_ns_ = now + kLagProbeMs * 1'000'000ULL;
+  } else if (event->timerId() == sample_timer_.timerId()) {
+    sample();
+  } else {
+    QWidget::timerEvent(event);
+  }
+}
+
+void PerfPanel::sample() {
+  const perf::Snapshot now = perf::snapshot();
+  perf::Snapshot delta = now;
+  for (size_t i = 0; i < delta.counters.size(); ++i) {
+    delta.counters[i] -= last_.counters[i];
+  }
+  for (size_t i = 0; i < delta.timings.size(); ++i) {
+    auto& h = delta.timings[i];
+    for (int b = 0; b < perf::kBuckets; ++b) h.buckets[b] -= last_.timings[i].buckets[b];
+    h.count -= last_.timings[i].count;
+    h.total_ns -= last_.timings[i].total_ns;
+  }
+  last_ = now;
+
+  window_.push_back(delta);
+  if (window_.size() > kWindowSeconds) window_.pop_front();
+  frame_rates_.push_back(delta.counters[(size_t)perf::Counter::FramesIngested] * 1000.0 / kSampleMs);
+  if (frame_rates_.size() > kRateHistory) frame_rates_.pop_front();
+
+  QStringList stream_stats = StreamManager::stream() ? StreamManager::stream()->statsLines() : QStringList();
+  if (stream_stats.size() != stream_stats_.size()) updateGeometry();
+  stream_stats_ = std::move(stream_stats);
+  update();
+}
+
+perf::Histogram PerfPanel::windowHistogram(perf::Timing t) const {
+  perf::Histogram sum;
+  for (const auto& s : window_) {
+    const auto& h = s.timings[(size_t)t];
+    for (int b = 0; b < perf::kBuckets; ++b) sum.buckets[b] += h.buckets[b];
+    sum.count += h.count;
+    sum.total_ns += h.total_ns;
+  }
+  return sum;
+}
+
+void PerfPanel::paintEvent(QPaintEvent* event) {
+  QPainter p(this);
+  p.fillRect(rect(), palette().base());
+  p.setPen(palette().text().color());
+
+  const QFontMetrics& fm = fontMetrics();
+  const int lh = fm.height() + kPadding;
+  const int cw = fm.horizontalAdvance(' ');
+  const QColor bar_color = palette().highlight().color();
+  int y = kPadding;
+
+  // Ingest rate over the last minute
+  const double rate = frame_rates_.empty() ? 0 : frame_rates_.back();
+  const int64_t depth = last_.gauges[(size_t)perf::Gauge::QueueDepth];
+  p.drawText(kPadding, y + fm.ascent(), tr("Ingest: %1 frames/s   Queue depth: %2").arg(rate, 0, 'f', 0).arg(depth));
+  y += lh;
+
+  const double max_rate = frame_rates_.empty() ? 0 : *std::max_element(frame_rates_.begin(), frame_rates_.end());
+  const int graph_w = width() - kPadding * 2;
+  p.fillRect(kPadding, y, graph_w, kGraphHeight, palette().alternateBase());
+  if (max_rate > 0) {
+    const double bar_w = (double)graph_w / kRateHistory;
+    const double x0 = kPadding + graph_w - bar_w * frame_rates_.size();
+    for (size_t i = 0; i < frame_rates_.size(); ++i) {
+      const int h = std::round(frame_rates_[i] / max_rate * kGraphHeight);
+      p.fillRect(QRectF(x0 + i * bar_w, y + kGraphHeight - h, std::max(1.0, bar_w - 1), h), bar_color);
+    }
+  }
+  y += kGraphHeight + kPadding;
+
+  for (const QString& line : stream_stats_) {
+    p.drawText(kPadding, y + fm.ascent(), line);
+    y += lh;
+  }
+
+  // One row per stage: rate, average and percentiles, then the histogram
+  const int cols[] = {kPadding, kPadding + cw * 22, kPadding + cw * 30, kPadding + cw * 38, kPadding + cw * 46};
+  const int hist_x = kPadding + cw * 54;
+  p.drawText(cols[0], y + fm.ascent(), tr("Stage"));
+  p.drawText(cols[1], y + fm.ascent(), tr("Calls/s"));
+  p.drawText(cols[2], y + fm.ascent(), tr("Avg"));
+  p.drawText(cols[3], y + fm.ascent(), tr("p50"));
+  p.drawText(cols[4], y + fm.ascent(), tr("p99"));
+  p.drawLine(kPadding, y + lh - 2, width() - kPadding, y + lh - 2);
+  y += lh;
+
+  const double window_sec = std::max<size_t>(1, window_.size()) * kSampleMs / 1000.0;
+  for (int t = 0; t < (int)perf::Timing::Count; ++t) {
+    const perf::Histogram h = windowHistogram((perf::Timing)t);
+    p.drawText(cols[0], y + fm.ascent(), perf::name((perf::Timing)t));
+    p.drawText(cols[1], y + fm.ascent(), QString::number(h.count / window_sec, 'f', 1));
+    if (h.count > 0) {
+      p.drawText(cols[2], y + fm.ascent(), formatNs((double)h.total_ns / h.count));
+      p.drawText(cols[3], y + fm.ascent(), formatNs(percentileNs(h, 0.5)));
+      p.drawText(cols[4], y + fm.ascent(), formatNs(percentileNs(h, 0.99)));
+    }
+
+    const uint64_t peak = *std::max_element(h.buckets.begin(), h.buckets.end());
+    p.fillRect(hist_x, y + 1, perf::kBuckets * kBarWidth, lh - 4, palette().alternateBase());
+    for (int b = 0; b < perf::kBuckets && peak > 0; ++b) {
+      const int bh = h.buckets[b] ? std::max(1, (int)std::round((double)h.buckets[b] / peak * (lh - 4))) : 0;
+      p.fillRect(hist_x + b * kBarWidth, y + lh - 3 - bh, kBarWidth - 1, bh, bar_color);
+    }
+    y += lh;
+  }
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <QBasicTimer>
+#include <QStringList>
+#include <QWidget>
+#include <deque>
+
+#include "utils/perf.h"
+
+// Shows the perf counters with a rolling histogram per pipeline stage. Instrumentation is only
+// enabled while the panel is visible.
+class PerfPanel : public QWidget {
+  Q_OBJECT
+
+ public:
+  explicit PerfPanel(QWidget* parent = nullptr);
+  QSize sizeHint() const override;
+
+ protected:
+  void showEvent(QShowEvent* event) override;
+  void hideEvent(QHideEvent* event) override;
+  void timerEvent(QTimerEvent* event) override;
+  void paintEvent(QPaintEvent* event) override;
+
+ private:
+  void sample();
+  perf::Histogram windowHistogram(perf::Timing t) const;
+
+  QBasicTimer sample_timer_;
+  QBasicTimer lag_timer_;
+  uint64_t lag_expected_ns_ = 0;
+
+  perf::Snapshot last_;
+  std::deque<perf::Snapshot> window_;  // Per-second deltas, most recent last
+  std::deque<double> frame_rates_;     // Frames ingested per second, most recent last
+  QStringList stream_stats_;
+};
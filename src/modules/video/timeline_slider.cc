@@ -7,6 +7,7 @@
 #include "modules/system/stream_manager.h"
 #include "playback_view.h"
 #include "replay/include/timeline.h"
+#include "utils/trace.h"
 
 const int kMargin = 9;  // Scrubber radius
 
@@ -50,6 +51,7 @@ void TimelineSlider::setThumbnailTime(double t) {
 }
 
 void TimelineSlider::paintEvent(QPaintEvent* ev) {
+  TRACE_SCOPE("TimelineSlider::paintEvent");
   QPainter p(this);
   const int track_w = width() - kMargin * 2;
   if (max_time <= min_time || track_w <= 0) return;
@@ -49,7 +49,12 @@ VideoPlayer::VideoPlayer(QWidget* parent) : QFrame(parent) {
         <td><span style="color:%6;">■ </span>Critical</td></tr>
     </table>
     <span style="color:gray">Shortcuts</span><br/>
-    Pause/Resume: <span style="background-color:lightGray;color:gray">&nbsp;space&nbsp;</span>
+    Pause/Resume: <span style="background-color:lightGray;color:gray">&nbsp;space&nbsp;</span><br/>
+    Play in reverse: <span style="background-color:lightGray;color:gray">&nbsp;shift+space&nbsp;</span><br/>
+    Step frame: <span style="background-color:lightGray;color:gray">&nbsp;,&nbsp;</span>
+    <span style="background-color:lightGray;color:gray">&nbsp;.&nbsp;</span><br/>
+    Step selected message: <span style="background-color:lightGray;color:gray">&nbsp;[&nbsp;</span>
+    <span style="background-color:lightGray;color:gray">&nbsp;]&nbsp;</span>
   )")
                    .arg(timeline_colors[(int)TimelineType::None].name(),
                         timeline_colors[(int)TimelineType::Engaged].name(),
@@ -252,6 +257,10 @@ void VideoPlayer::updatePlayBtnState() {
 void VideoPlayer::showThumbnail(double seconds) {
   if (StreamManager::stream()->liveStreaming()) return;
 
+  if (auto* replay_stream = qobject_cast<ReplayStream*>(StreamManager::stream())) {
+    replay_stream->prefetchHint(seconds);
+  }
+
   cam_widget->thumbnail_dispaly_time = seconds;
   cam_widget->update();
 }
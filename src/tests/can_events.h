@@ -0,0 +1,43 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <deque>
+
+#include "core/dbc/dbc_signal.h"
+#include "core/streams/abstract_stream.h"
+
+// Events of one message, one every 10ms, whose first byte holds a changing value
+class CanEventSource {
+ public:
+  explicit CanEventSource(const MessageId& id) : id_(id) {}
+
+  MessageEventsMap take(int count) {
+    MessageEventsMap events;
+    for (int i = 0; i < count; ++i, ++n_) {
+      auto* e = reinterpret_cast<CanEvent*>(storage_.emplace_back().data());
+      e->mono_ns = n_ * 10'000'000ULL;
+      e->src = id_.source;
+      e->address = id_.address;
+      e->size = 8;
+      std::fill_n(e->dat, 8, 0);
+      e->dat[0] = (n_ * 37) % 101;
+      events[id_].push_back(e);
+    }
+    return events;
+  }
+
+ private:
+  const MessageId id_;
+  int n_ = 0;
+  std::deque<std::array<uint64_t, 3>> storage_;  // CanEvent header plus 8 data bytes each
+};
+
+// The first byte of the message
+inline dbc::Signal byteSignal() {
+  dbc::Signal sig;
+  sig.name = "value";
+  sig.size = 8;
+  sig.update();
+  return sig;
+}
@@ -0,0 +1,64 @@
+#!/usr/bin/env python3
+"""Writes panda_transfers.bin, a stand-in for a panda USB recording, and panda_frames.txt.
+
+The recording holds bulk IN transfers as a panda sends them: each is a little-endian uint32 length
+followed by that many bytes of packed CAN frames, and frames straddle transfer boundaries.
+The frames cycle through buses 0-2, standard and extended ids and every CAN FD length, with a
+few rejected and returned ones mixed in.
+
+panda_frames.txt is what unpacking should give. Its first line is the frame count and a 32-bit
+FNV-1a hash over every frame's src, little-endian address, length and data. Each further line is
+one of the first SAMPLE_FRAMES frames as src, hex address and hex data.
+"""
+import random
+import struct
+from pathlib import Path
+
+FRAMES = 3000
+SAMPLE_FRAMES = 32
+DLC_TO_LEN = [0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64]
+
+
+def pack_frame(rng):
+  bus = rng.randrange(3)
+  dlc = rng.randrange(16) if rng.random() < 0.3 else 8
+  extended = rng.random() < 0.2
+  addr = rng.randrange(1 << 29) if extended else rng.randrange(1 << 11)
+  rejected = rng.random() < 0.01
+  returned = not rejected and rng.random() < 0.01
+  header = bytearray(struct.pack('<BI', (bus << 1) | (dlc << 4), rejected | (returned << 1) | (extended << 2) | (addr << 3)))
+  data = bytes(rng.randrange(256) for _ in range(DLC_TO_LEN[dlc]))
+  checksum = 0
+  for b in header + data:
+    checksum ^= b
+  src = bus + (0xC0 if rejected else 0) + (0x80 if returned else 0)
+  return bytes(header) + bytes([checksum]) + data, (src, addr, data)
+
+
+def fnv1a(h, data):
+  for b in data:
+    h = ((h ^ b) * 0x01000193) & 0xFFFFFFFF
+  return h
+
+
+def main():
+  rng = random.Random(1)
+  packed, frames = zip(*(pack_frame(rng) for _ in range(FRAMES)))
+  stream = b''.join(packed)
+  out = bytearray()
+  pos = 0
+  while pos < len(stream):
+    size = min(rng.randrange(64, 2048), len(stream) - pos)
+    out += struct.pack('<I', size) + stream[pos:pos + size]
+    pos += size
+  Path(__file__).with_name('panda_transfers.bin').write_bytes(out)
+
+  h = 0x811C9DC5
+  for src, addr, data in frames:
+    h = fnv1a(h, struct.pack('<BIB', src, addr, len(data)) + data)
+  lines = [f'{FRAMES} {h:08x}'] + [f'{src} {addr:x} {data.hex()}' for src, addr, data in frames[:SAMPLE_FRAMES]]
+  Path(__file__).with_name('panda_frames.txt').write_text('\n'.join(lines) + '\n')
+
+
+if __name__ == '__main__':
+  main()
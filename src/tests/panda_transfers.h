@@ -0,0 +1,37 @@
+#pragma once
+
+#include <QtTest/QTest>
+#include <vector>
+
+#include "core/streams/panda_replay.h"
+
+// As written by data/make_panda_transfers.py
+constexpr int kPandaFrames = 3000;
+constexpr int kPandaRejectedOrReturned = 77;
+
+inline std::vector<QByteArray> loadPandaTransfers() {
+  return PandaReplay::load(QFINDTESTDATA("data/panda_transfers.bin"));
+}
+
+// Breaks the checksum of the frame with index `frame` and returns the transfers up to the one
+// holding it
+inline std::vector<QByteArray> breakChecksum(const std::vector<QByteArray>& transfers, int frame) {
+  constexpr uint8_t kDlcToLen[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64};
+  QByteArray stream;
+  for (const QByteArray& t : transfers) stream += t;
+  qsizetype pos = 0;
+  for (int i = 0; i < frame; ++i) pos += sizeof(can_header) + kDlcToLen[uint8_t(stream[pos]) >> 4];
+  const qsizetype checksum_pos = pos + sizeof(can_header) - 1;  // The last byte of the header
+
+  std::vector<QByteArray> broken;
+  qsizetype offset = 0;
+  for (const QByteArray& t : transfers) {
+    broken.push_back(t);
+    if (checksum_pos < offset + t.size()) {
+      broken.back()[checksum_pos - offset] ^= 0x01;
+      break;
+    }
+    offset += t.size();
+  }
+  return broken;
+}
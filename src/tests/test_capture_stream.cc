@@ -0,0 +1,105 @@
+#include "tests/test_capture_stream.h"
+
+#include <QCoreApplication>
+#include <QTemporaryDir>
+#include <QtTest/QTest>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <deque>
+#include <memory>
+
+#include "core/streams/capture_stream.h"
+#include "core/streams/capture_writer.h"
+
+namespace {
+
+constexpr int kSeconds = 600;
+constexpr int kMessages = 10;          // Each sent every 10 ms
+constexpr int kRareTick = 10'000;      // At 100 s, outside what is decoded when opening or seeking to kSeekSec
+constexpr double kSeekSec = 500.0;
+const MessageId kRareId(1, 0x7ff);     // Only sent once
+
+// A capture of regular traffic plus one message that is only sent once
+class CaptureFile {
+ public:
+  CaptureFile() {
+    std::vector<const CanEvent*> events;
+    for (int tick = 0; tick < kSeconds * 100; ++tick) {
+      const uint64_t mono_ns = 1'000'000'000ULL + tick * 10'000'000ULL;
+      for (int m = 0; m < kMessages; ++m) events.push_back(add(mono_ns, MessageId(0, 0x100 + m), tick));
+      if (tick == kRareTick) events.push_back(add(mono_ns, kRareId, 42));
+    }
+    count = events.size();
+
+    CaptureWriter writer(path(), false);
+    writer.append(events);
+  }
+
+  QString path() const { return dir_.filePath("test.ccap"); }
+  size_t count = 0;
+
+ private:
+  const CanEvent* add(uint64_t mono_ns, const MessageId& id, uint8_t value) {
+    auto* e = reinterpret_cast<CanEvent*>(storage_.emplace_back().data());
+    e->mono_ns = mono_ns;
+    e->src = id.source;
+    e->address = id.address;
+    e->size = 8;
+    std::fill_n(e->dat, 8, 0);
+    e->dat[0] = value;
+    return e;
+  }
+
+  QTemporaryDir dir_;
+  std::deque<std::array<uint64_t, 3>> storage_;  // CanEvent header plus 8 data bytes each
+};
+
+std::unique_ptr<CaptureFile> capture;
+
+}  // namespace
+
+void TestCaptureStream::initTestCase() {
+  capture = std::make_unique<CaptureFile>();
+  QVERIFY(QFile::exists(capture->path()));
+}
+
+void TestCaptureStream::cleanupTestCase() { capture.reset(); }
+
+void TestCaptureStream::opensFirstBlocksOnly() {
+  CaptureStream stream(qApp, {capture->path()});
+  QVERIFY(qFuzzyCompare(stream.maxSeconds(), kSeconds - 0.01));
+  QVERIFY(stream.decodedBlocks() > 0);
+  QVERIFY(stream.decodedBlocks() < stream.blockCount());
+
+  const double decoded_sec = stream.toSeconds(stream.allEvents().back()->mono_ns);
+  QVERIFY(decoded_sec >= 30.0);
+  QVERIFY(decoded_sec < 60.0);
+}
+
+void TestCaptureStream::seekDecodesLastValues() {
+  CaptureStream stream(qApp, {capture->path()});
+  stream.seekTo(kSeekSec);
+
+  // The block with the rare message was found through the message index
+  const auto& rare = stream.events(kRareId);
+  QCOMPARE(rare.size(), size_t(1));
+  QCOMPARE(rare.front()->dat[0], uint8_t(42));
+  QVERIFY(std::ranges::is_sorted(stream.allEvents(), {}, &CanEvent::mono_ns));
+
+  // The regular messages come from the blocks around the target
+  const auto& regular = stream.events(MessageId(0, 0x100));
+  auto near_target = [&](const CanEvent* e) { return std::abs(stream.toSeconds(e->mono_ns) - kSeekSec) < 0.011; };
+  QVERIFY(std::ranges::any_of(regular, near_target));
+  QVERIFY(stream.decodedBlocks() < stream.blockCount() / 2);
+}
+
+void TestCaptureStream::decodeAll() {
+  CaptureStream stream(qApp, {capture->path()});
+  stream.decodeAll();
+  QCOMPARE(stream.decodedBlocks(), stream.blockCount());
+  QCOMPARE(stream.allEvents().size(), capture->count);
+  QVERIFY(std::ranges::is_sorted(stream.allEvents(), {}, &CanEvent::mono_ns));
+}
+
+QTEST_MAIN(TestCaptureStream)
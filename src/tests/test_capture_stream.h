@@ -0,0 +1,14 @@
+#pragma once
+
+#include <QObject>
+
+class TestCaptureStream : public QObject {
+  Q_OBJECT
+
+ private slots:
+  void initTestCase();
+  void cleanupTestCase();
+  void opensFirstBlocksOnly();
+  void seekDecodesLastValues();
+  void decodeAll();
+};
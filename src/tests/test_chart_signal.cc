@@ -0,0 +1,82 @@
+#include "tests/test_chart_signal.h"
+
+#include <QtTest/QTest>
+
+#include "modules/charts/components/chart_signal.h"
+#include "tests/can_events.h"
+
+namespace {
+
+const MessageId kMsgId(0, 0x100);
+constexpr int kWidth = 1000;
+
+// What a full replace of the series shows for raw points
+QList<QPointF> expectedPoints(const ChartSignal& s, SeriesType type, double min_x, double max_x) {
+  const auto [begin, end] = LodPyramid::visibleRange(s.vals, s.vals.size(), min_x, max_x);
+  QList<QPointF> points;
+  for (size_t i = begin; i < end; ++i) {
+    if (type == SeriesType::StepLine && i > begin) points.push_back({s.vals[i].x(), s.vals[i - 1].y()});
+    points.push_back(s.vals[i]);
+  }
+  return points;
+}
+
+// Grows and scrolls the data in small steps, each update has to match a full replace
+void checkScrolling(SeriesType type) {
+  const dbc::Signal sig = byteSignal();
+  QLineSeries series;
+  ChartSignal s(kMsgId, &sig, &series);
+  CanEventSource source(kMsgId);
+
+  double min_x = 0, max_x = 1.0;
+  MessageEventsMap events = source.take(50);
+  s.prepareData(&events, min_x, max_x);
+  s.updateSeries(type, min_x, max_x, kWidth);
+  QCOMPARE(series.points(), expectedPoints(s, type, min_x, max_x));
+
+  for (int round = 0; round < 100; ++round) {
+    events = source.take(1 + round % 5);
+    s.prepareData(&events, min_x, max_x);
+    if (s.vals.back().x() > max_x) {
+      min_x += 0.03;
+      max_x += 0.03;
+    }
+    // An incremental update only appends the new points, a step line two per value
+    int added = 0, replaced = 0;
+    auto on_added = QObject::connect(&series, &QXYSeries::pointAdded, [&added]() { ++added; });
+    auto on_replaced = QObject::connect(&series, &QXYSeries::pointsReplaced, [&replaced]() { ++replaced; });
+    s.updateSeries(type, min_x, max_x, kWidth);
+    QObject::disconnect(on_added);
+    QObject::disconnect(on_replaced);
+
+    QCOMPARE(series.points(), expectedPoints(s, type, min_x, max_x));
+    QCOMPARE(replaced, 0);
+    QVERIFY(added <= (type == SeriesType::StepLine ? 2 : 1) * 5);
+  }
+}
+
+}  // namespace
+
+void TestChartSignal::lineAppendsInPlace() { checkScrolling(SeriesType::Line); }
+
+void TestChartSignal::stepLineAppendsInPlace() { checkScrolling(SeriesType::StepLine); }
+
+void TestChartSignal::clearedSeriesIsRefilled() {
+  const dbc::Signal sig = byteSignal();
+  QLineSeries series;
+  ChartSignal s(kMsgId, &sig, &series);
+  CanEventSource source(kMsgId);
+  MessageEventsMap events = source.take(50);
+  s.prepareData(&events, 0, 1.0);
+  s.updateSeries(SeriesType::Line, 0, 1.0, kWidth);
+
+  // A raster chart empties the series, switching back has to fill it again rather than append to it
+  s.clearSeries();
+  QCOMPARE(series.count(), 0);
+  events = source.take(3);
+  s.prepareData(&events, 0, 1.0);
+  s.updateSeries(SeriesType::Line, 0, 1.0, kWidth);
+  QCOMPARE(series.points(), expectedPoints(s, SeriesType::Line, 0, 1.0));
+}
+
+QTEST_MAIN(TestChartSignal)
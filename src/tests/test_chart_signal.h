@@ -0,0 +1,12 @@
+#pragma once
+
+#include <QObject>
+
+class TestChartSignal : public QObject {
+  Q_OBJECT
+
+ private slots:
+  void lineAppendsInPlace();
+  void stepLineAppendsInPlace();
+  void clearedSeriesIsRefilled();
+};
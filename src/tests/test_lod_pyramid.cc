@@ -0,0 +1,107 @@
+#include "tests/test_lod_pyramid.h"
+
+#include <QtTest/QTest>
+#include <random>
+#include <vector>
+
+#include "utils/lod_pyramid.h"
+#include "utils/range_minmax.h"
+
+namespace {
+
+void appendRandom(std::vector<QPointF>& pts, std::mt19937& rng, int count) {
+  for (int i = 0; i < count; ++i) pts.emplace_back(pts.size() * 0.01, double(rng() % 1000));
+}
+
+}  // namespace
+
+void TestLodPyramid::rawWhenSparse() {
+  std::vector<QPointF> pts;
+  for (int i = 0; i < 100; ++i) pts.emplace_back(i, i % 7);
+  LodPyramid lod;
+  lod.append(pts);
+
+  // 21 points inside the range plus one past each end, well under 4 per pixel
+  QList<QPointF> out;
+  lod.visiblePoints(pts, 10, 30, 100, out);
+  QCOMPARE(out.size(), qsizetype(23));
+  QCOMPARE(out.front().x(), 9.0);
+  QCOMPARE(out.back().x(), 31.0);
+
+  // Past the data only the last point remains, for the line leading into the range
+  lod.visiblePoints(pts, 200, 300, 100, out);
+  QCOMPARE(out.size(), qsizetype(1));
+  QCOMPARE(out.front().x(), 99.0);
+}
+
+void TestLodPyramid::decimatedKeepsExtremes() {
+  std::mt19937 rng(1);
+  std::vector<QPointF> pts;
+  appendRandom(pts, rng, 200'000);
+  LodPyramid lod;
+  lod.append(pts);
+
+  QList<QPointF> out;
+  for (int round = 0; round < 200; ++round) {
+    const double min_x = (rng() % 200'000) * 0.01;
+    const double max_x = min_x + (rng() % 100'000) * 0.01;
+    const int width = 1 + rng() % 1000;
+    lod.visiblePoints(pts, min_x, max_x, width, out);
+
+    const auto [begin, end] = LodPyramid::visibleRange(pts, pts.size(), min_x, max_x);
+    const size_t visible = end - begin;
+    if (LodPyramid::isDecimated(visible, width)) {
+      // About four points per pixel, plus the raw points of the partly covered buckets at the ends
+      QVERIFY((size_t)out.size() <= 8 * width + 4 * visible / width);
+    } else {
+      QCOMPARE((size_t)out.size(), visible);
+    }
+
+    MinMax expected, shown;
+    for (const auto& p : pts) {
+      if (p.x() >= min_x && p.x() <= max_x) expected.combine(p.y());
+    }
+    for (int i = 0; i < out.size(); ++i) {
+      if (out[i].x() >= min_x && out[i].x() <= max_x) shown.combine(out[i].y());
+      if (i > 0) QVERIFY(out[i].x() > out[i - 1].x());
+    }
+    QCOMPARE(shown.min, expected.min);
+    QCOMPARE(shown.max, expected.max);
+  }
+}
+
+void TestLodPyramid::appendMatchesRebuild() {
+  std::mt19937 rng(2);
+  std::vector<QPointF> pts;
+  LodPyramid lod;
+  QList<QPointF> out, rebuilt_out;
+  for (int round = 0; round < 50; ++round) {
+    appendRandom(pts, rng, rng() % 5000);
+    lod.append(pts);
+    LodPyramid rebuilt;
+    rebuilt.append(pts);
+
+    const double min_x = (rng() % 100'000) * 0.01 * pts.size() / 100'000;
+    const double max_x = min_x + (rng() % 10'000) * 0.01;
+    const int width = 1 + rng() % 500;
+    lod.visiblePoints(pts, min_x, max_x, width, out);
+    rebuilt.visiblePoints(pts, min_x, max_x, width, rebuilt_out);
+    QCOMPARE(out, rebuilt_out);
+  }
+}
+
+void TestLodPyramid::benchmarkVisiblePoints() {
+  std::mt19937 rng(3);
+  std::vector<QPointF> pts;
+  appendRandom(pts, rng, 2'000'000);
+  LodPyramid lod;
+  lod.append(pts);
+
+  QList<QPointF> out;
+  QBENCHMARK {
+    lod.visiblePoints(pts, 0, pts.back().x(), 1000, out);
+  }
+  QVERIFY((size_t)out.size() <= 8 * 1000 + 4 * pts.size() / 1000);
+}
+
+QTEST_APPLESS_MAIN(TestLodPyramid)
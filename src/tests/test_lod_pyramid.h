@@ -0,0 +1,13 @@
+#pragma once
+
+#include <QObject>
+
+class TestLodPyramid : public QObject {
+  Q_OBJECT
+
+ private slots:
+  void rawWhenSparse();
+  void decimatedKeepsExtremes();
+  void appendMatchesRebuild();
+  void benchmarkVisiblePoints();
+};
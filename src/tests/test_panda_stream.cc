@@ -0,0 +1,68 @@
+#include "tests/test_panda_stream.h"
+
+#include <QCoreApplication>
+#include <QtTest/QTest>
+#include <algorithm>
+
+#include "core/streams/panda_stream.h"
+#include "modules/settings/settings.h"
+#include "tests/panda_transfers.h"
+
+namespace {
+
+// Plays the transfers through a PandaStream until they are all merged into its events
+struct ReplayedStream {
+  explicit ReplayedStream(std::vector<QByteArray> transfers)
+      : replay(new PandaReplay(std::move(transfers))), stream(qApp, std::unique_ptr<PandaTransport>(replay)) {
+    stream.start();
+  }
+
+  // Waits for `frames` events, then stops the stream so the transport counters are final
+  bool finish(size_t frames) {
+    const bool arrived = QTest::qWaitFor([&]() { return stream.allEvents().size() >= frames; }, 10'000);
+    stream.stop();
+    return arrived && stream.allEvents().size() == frames;
+  }
+
+  PandaReplay* replay;  // Owned by the stream
+  PandaStream stream;
+};
+
+}  // namespace
+
+void TestPandaStream::initTestCase() { settings.log_livestream = false; }
+
+void TestPandaStream::streamsRecording() {
+  const auto transfers = loadPandaTransfers();
+  QVERIFY(!transfers.empty());
+
+  ReplayedStream r(transfers);
+  QVERIFY(r.finish(kPandaFrames));
+  QCOMPARE(r.replay->resets(), 0);
+  QVERIFY(r.replay->heartbeats() > 0);
+
+  const auto& events = r.stream.allEvents();
+  QVERIFY(std::ranges::is_sorted(events, {}, &CanEvent::mono_ns));
+  const int flagged = std::ranges::count_if(events, [](auto* e) { return e->src >= CAN_RETURNED_BUS_OFFSET; });
+  QCOMPARE(flagged, kPandaRejectedOrReturned);
+  for (uint8_t bus = 0; bus < 3; ++bus) {
+    QVERIFY(std::ranges::any_of(events, [bus](auto* e) { return e->src == bus; }));
+  }
+}
+
+void TestPandaStream::checksumFailureResets() {
+  const auto transfers = loadPandaTransfers();
+  QVERIFY(!transfers.empty());
+
+  // After the broken frame the rest of its transfer is dropped and communication is reset. The
+  // recording then plays again from a frame boundary, as a panda sends after the reset.
+  constexpr int kBroken = 100;
+  auto replayed = breakChecksum(transfers, kBroken);
+  replayed.insert(replayed.end(), transfers.begin(), transfers.end());
+
+  ReplayedStream r(replayed);
+  QVERIFY(r.finish(kBroken + kPandaFrames));
+  QCOMPARE(r.replay->resets(), 1);
+}
+
+QTEST_MAIN(TestPandaStream)
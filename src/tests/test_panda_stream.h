@@ -0,0 +1,12 @@
+#pragma once
+
+#include <QObject>
+
+class TestPandaStream : public QObject {
+  Q_OBJECT
+
+ private slots:
+  void initTestCase();
+  void streamsRecording();
+  void checksumFailureResets();
+};
@@ -0,0 +1,134 @@
+#include "tests/test_panda_unpack.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QtTest/QTest>
+#include <vector>
+
+#include "tests/panda_transfers.h"
+
+namespace {
+
+constexpr size_t kSampleFrames = 32;  // Kept in full, as many as data/panda_frames.txt lists
+
+struct Frame {
+  uint8_t src;
+  uint32_t address;
+  QByteArray data;
+};
+
+struct UnpackResult {
+  int frames = 0;
+  int rejected_or_returned = 0;
+  uint32_t hash = 0x811c9dc5;  // FNV-1a over src, little-endian address, length and data of every frame
+  std::vector<Frame> first;
+  uint32_t left = 0;  // Bytes of a partial frame still in the buffer
+  bool ok = true;
+};
+
+uint32_t fnv1a(uint32_t hash, const uint8_t* data, size_t size) {
+  for (size_t i = 0; i < size; ++i) hash = (hash ^ data[i]) * 0x01000193u;
+  return hash;
+}
+
+// What data/make_panda_transfers.py wrote down for the recording, in the same form
+UnpackResult expectedResult() {
+  UnpackResult expected;
+  QFile file(QFINDTESTDATA("data/panda_frames.txt"));
+  if (!file.open(QIODevice::ReadOnly)) return expected;
+
+  const QList<QByteArray> lines = file.readAll().trimmed().split('\n');
+  const QList<QByteArray> summary = lines.value(0).split(' ');
+  expected.frames = summary.value(0).toInt();
+  expected.hash = summary.value(1).toUInt(nullptr, 16);
+  for (qsizetype i = 1; i < lines.size(); ++i) {
+    const QList<QByteArray> fields = lines[i].split(' ');
+    expected.first.push_back({uint8_t(fields.value(0).toUInt()), fields.value(1).toUInt(nullptr, 16),
+                              QByteArray::fromHex(fields.value(2))});
+  }
+  return expected;
+}
+
+// Feeds the transfers through the unpacker the way PandaStream does, carrying partial frames over
+UnpackResult unpack(const std::vector<QByteArray>& transfers, std::vector<uint8_t>& buffer) {
+  UnpackResult result;
+  auto sink = [&result](uint8_t src, uint32_t address, const uint8_t* dat, uint8_t len) {
+    ++result.frames;
+    result.rejected_or_returned += src >= CAN_RETURNED_BUS_OFFSET;
+    const uint8_t key[] = {src, uint8_t(address), uint8_t(address >> 8), uint8_t(address >> 16), uint8_t(address >> 24),
+                           len};
+    result.hash = fnv1a(fnv1a(result.hash, key, sizeof(key)), dat, len);
+    if (result.first.size() < kSampleFrames) {
+      result.first.push_back({src, address, QByteArray(reinterpret_cast<const char*>(dat), len)});
+    }
+  };
+
+  uint32_t size = 0;
+  for (const QByteArray& transfer : transfers) {
+    const uint32_t len = transfer.size();
+    if (buffer.size() < size + len) buffer.resize(size + len);
+    memcpy(buffer.data() + size, transfer.data(), len);
+    size += len;
+    result.ok &= Panda::unpack_can_buffer(buffer.data(), size, 0, sink);
+  }
+  result.left = size;
+  return result;
+}
+
+}  // namespace
+
+void TestPandaUnpack::unpackRecording() {
+  const auto transfers = loadPandaTransfers();
+  QVERIFY(transfers.size() > 1);
+
+  std::vector<uint8_t> buffer;
+  const UnpackResult result = unpack(transfers, buffer);
+  QVERIFY(result.ok);
+  QCOMPARE(result.frames, kPandaFrames);
+  QCOMPARE(result.rejected_or_returned, kPandaRejectedOrReturned);
+  QCOMPARE(result.left, 0u);
+
+  // Headers, lengths and payloads decode to what was packed
+  const UnpackResult expected = expectedResult();
+  QCOMPARE(expected.frames, kPandaFrames);
+  QCOMPARE(result.hash, expected.hash);
+  QCOMPARE(expected.first.size(), kSampleFrames);
+  for (size_t i = 0; i < kSampleFrames; ++i) {
+    QCOMPARE(int(result.first[i].src), int(expected.first[i].src));
+    QCOMPARE(result.first[i].address, expected.first[i].address);
+    QCOMPARE(result.first[i].data, expected.first[i].data);
+  }
+}
+
+void TestPandaUnpack::checksumFailure() {
+  const auto transfers = loadPandaTransfers();
+  QVERIFY(!transfers.empty());
+
+  constexpr int kBroken = 100;
+  std::vector<uint8_t> buffer;
+  const UnpackResult result = unpack(breakChecksum(transfers, kBroken), buffer);
+  QVERIFY(!result.ok);
+  // Frames ahead of the broken one come through, the rest of the buffer is discarded
+  QCOMPARE(result.frames, kBroken);
+  QCOMPARE(result.left, 0u);
+}
+
+void TestPandaUnpack::benchmarkUnpack() {
+  const auto transfers = loadPandaTransfers();
+  QVERIFY(!transfers.empty());
+
+  std::vector<uint8_t> buffer;
+  QBENCHMARK {
+    QCOMPARE(unpack(transfers, buffer).frames, kPandaFrames);
+  }
+
+  // A fully loaded red panda delivers some 30k frames/s, the unpacker has to keep far ahead of that
+  constexpr int kRounds = 100;
+  QElapsedTimer timer;
+  timer.start();
+  for (int i = 0; i < kRounds; ++i) unpack(transfers, buffer);
+  const double frames_per_sec = double(kRounds) * kPandaFrames / std::max<qint64>(timer.nsecsElapsed(), 1) * 1e9;
+  QVERIFY2(frames_per_sec > 1e6, qPrintable(QString("%1 frames/s").arg(frames_per_sec, 0, 'f', 0)));
+}
+
+QTEST_APPLESS_MAIN(TestPandaUnpack)
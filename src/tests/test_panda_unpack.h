@@ -0,0 +1,12 @@
+#pragma once
+
+#include <QObject>
+
+class TestPandaUnpack : public QObject {
+  Q_OBJECT
+
+ private slots:
+  void unpackRecording();
+  void checksumFailure();
+  void benchmarkUnpack();
+};
@@ -0,0 +1,110 @@
+#include "tests/test_range_minmax.h"
+
+#include <QtTest/QTest>
+#include <deque>
+#include <random>
+#include <vector>
+
+#include "utils/range_minmax.h"
+
+namespace {
+
+struct Sample {
+  double value;
+  friend double minMaxValue(const Sample& s) { return s.value; }
+};
+
+// Compares random queries against a plain scan of the series
+template <typename Series>
+void checkQueries(const RangeMinMax& index, const Series& series, std::mt19937& rng, int count) {
+  for (int q = 0; q < count && !series.empty(); ++q) {
+    const size_t l = rng() % series.size();
+    const size_t r = l + rng() % (series.size() - l);
+    MinMax expected;
+    for (size_t i = l; i <= r; ++i) expected.combine(minMaxValue(series[i]));
+    const MinMax m = index.query(series, l, r);
+    QCOMPARE(m.min, expected.min);
+    QCOMPARE(m.max, expected.max);
+  }
+}
+
+void appendRandom(std::vector<QPointF>& series, std::mt19937& rng, int count) {
+  for (int i = 0; i < count; ++i) series.emplace_back(series.size(), double(rng() % 100000));
+}
+
+}  // namespace
+
+void TestRangeMinMax::queryMatchesScan() {
+  std::mt19937 rng(1);
+  std::vector<QPointF> series;
+  RangeMinMax index;
+  for (int round = 0; round < 200 && !QTest::currentTestFailed(); ++round) {
+    appendRandom(series, rng, rng() % 700);
+    index.append(series);
+    checkQueries(index, series, rng, 50);
+  }
+}
+
+void TestRangeMinMax::outOfRangeQuery() {
+  std::vector<QPointF> series{{0, 1}, {1, 2}};
+  RangeMinMax index;
+  index.append(series);
+  const MinMax empty;
+  QCOMPARE(index.query(series, 1, 0).min, empty.min);
+  QCOMPARE(index.query(series, 0, 2).max, empty.max);
+  QCOMPARE(index.query(series, 0, 1).max, 2.0);
+}
+
+void TestRangeMinMax::insertRebuildsTail() {
+  std::mt19937 rng(2);
+  std::vector<QPointF> series;
+  RangeMinMax index;
+  appendRandom(series, rng, 5000);
+  index.append(series);
+  for (int round = 0; round < 200 && !QTest::currentTestFailed(); ++round) {
+    const size_t pos = rng() % series.size();
+    std::vector<QPointF> inserted;
+    appendRandom(inserted, rng, 1 + rng() % 50);
+    series.insert(series.begin() + pos, inserted.begin(), inserted.end());
+    index.invalidateFrom(pos);
+    index.append(series);
+    checkQueries(index, series, rng, 50);
+  }
+}
+
+void TestRangeMinMax::slidingWindow() {
+  std::mt19937 rng(3);
+  std::deque<Sample> series;
+  RangeMinMax index;
+  for (int round = 0; round < 3000 && !QTest::currentTestFailed(); ++round) {
+    const int added = rng() % 300;
+    for (int i = 0; i < added; ++i) series.push_back({double(rng() % 100000)});
+    // Sometimes drop more than is left, which makes the index start over
+    const size_t dropped = std::min<size_t>(series.size(), rng() % 300);
+    series.erase(series.begin(), series.begin() + dropped);
+    index.dropFront(dropped);
+    index.append(series);
+    checkQueries(index, series, rng, 10);
+  }
+}
+
+void TestRangeMinMax::benchmarkQuery() {
+  std::mt19937 rng(4);
+  std::vector<QPointF> series;
+  appendRandom(series, rng, 1'000'000);
+  RangeMinMax index;
+  index.append(series);
+  // The index is a small fraction of the series it covers
+  QVERIFY(index.memoryUsage() < series.size() * sizeof(QPointF) / 4);
+
+  double sum = 0;
+  QBENCHMARK {
+    for (int q = 0; q < 1000; ++q) {
+      const size_t l = rng() % series.size();
+      sum += index.query(series, l, l + rng() % (series.size() - l)).max;
+    }
+  }
+  QVERIFY(sum > 0);
+}
+
+QTEST_APPLESS_MAIN(TestRangeMinMax)
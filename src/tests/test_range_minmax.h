@@ -0,0 +1,14 @@
+#pragma once
+
+#include <QObject>
+
+class TestRangeMinMax : public QObject {
+  Q_OBJECT
+
+ private slots:
+  void queryMatchesScan();
+  void outOfRangeQuery();
+  void insertRebuildsTail();
+  void slidingWindow();
+  void benchmarkQuery();
+};
@@ -0,0 +1,76 @@
+#include "tests/test_raster_series.h"
+
+#include <QPainter>
+#include <QtTest/QTest>
+
+#include "modules/charts/chart.h"
+#include "tests/can_events.h"
+
+namespace {
+
+const MessageId kMsgId(0, 0x100);
+
+// A raster chart over [0, 2] seconds with 200 points of one signal, drawn into 1 second tiles
+struct RasterChart {
+  RasterChart() : chart(new Chart(&view)), source(kMsgId) {
+    view.setChart(chart);
+    chart->setSeriesType(SeriesType::Raster);
+    chart->addSignal(kMsgId, &sig);
+    append(200);
+    chart->axis_x_->setRange(0, 2);
+    chart->axis_y_->setRange(0, 100);
+    for (QGraphicsItem* child : chart->childItems()) {
+      if (auto* raster = dynamic_cast<RasterSeriesItem*>(child)) item = raster;
+    }
+    item->setPlotArea(QRectF(0, 0, 512, 100));
+  }
+
+  void append(int count) {
+    MessageEventsMap events = source.take(count);
+    chart->prepareData(&sig, &events);
+  }
+
+  void paint() {
+    QImage image(600, 200, QImage::Format_ARGB32_Premultiplied);
+    QPainter p(&image);
+    item->paint(&p, nullptr, nullptr);
+  }
+
+  const dbc::Signal sig = byteSignal();
+  QChartView view;
+  Chart* chart;
+  CanEventSource source;
+  RasterSeriesItem* item = nullptr;
+};
+
+}  // namespace
+
+void TestRasterSeries::appendKeepsFinishedTiles() {
+  RasterChart c;
+  c.paint();
+  auto& tiles = c.item->tiles_;
+  QCOMPARE(tiles.size(), size_t(3));
+  for (const auto& [index, tile] : tiles) QVERIFY(c.item->isCurrent(tile, index));
+
+  // Points up to 2.49s: the first tile already holds the line leaving it, the others change
+  c.append(50);
+  QVERIFY(c.item->isCurrent(tiles.at(0), 0));
+  QVERIFY(!c.item->isCurrent(tiles.at(1), 1));
+  QVERIFY(!c.item->isCurrent(tiles.at(2), 2));
+
+  c.paint();
+  for (const auto& [index, tile] : tiles) QVERIFY(c.item->isCurrent(tile, index));
+}
+
+void TestRasterSeries::reloadDropsAllTiles() {
+  RasterChart c;
+  c.paint();
+  auto& tiles = c.item->tiles_;
+  QCOMPARE(tiles.size(), size_t(3));
+
+  // Reloading from the stream replaces the values, even those behind finished tiles
+  c.chart->prepareData(&c.sig);
+  for (const auto& [index, tile] : tiles) QVERIFY(!c.item->isCurrent(tile, index));
+}
+
+QTEST_MAIN(TestRasterSeries)
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <QObject>
+
+class TestRasterSeries : public QObject {
+  Q_OBJECT
+
+ private slots:
+  void appendKeepsFinishedTiles();
+  void reloadDropsAllTiles();
+};
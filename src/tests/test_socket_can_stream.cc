@@ -0,0 +1,163 @@
+#include "tests/test_socket_can_stream.h"
+
+#include <QCoreApplication>
+#include <QThread>
+#include <QtTest/QTest>
+#include <algorithm>
+
+#include "common/timing.h"
+#include "core/streams/socket_can_stream.h"
+#include "modules/settings/settings.h"
+
+#ifdef __linux__
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#include <net/if.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace {
+
+const QStringList kDevices = {"vcan0", "vcan1"};
+constexpr int kFramesPerDevice = 1000;
+
+// Raw socket that writes frames onto a single interface
+struct CanSender {
+  explicit CanSender(const QString& device) {
+    fd = socket(PF_CAN, SOCK_RAW | SOCK_CLOEXEC, CAN_RAW);
+    sockaddr_can addr = {};
+    addr.can_family = AF_CAN;
+    addr.can_ifindex = if_nametoindex(device.toUtf8().constData());
+    if (fd >= 0 && bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+      close(fd);
+      fd = -1;
+    }
+  }
+  ~CanSender() {
+    if (fd >= 0) close(fd);
+  }
+
+  // The frame carries its global send order so the merged stream can be checked against it
+  bool send(uint32_t address, uint32_t seq) {
+    can_frame frame = {};
+    frame.can_id = address;
+    frame.len = sizeof(seq);
+    std::memcpy(frame.data, &seq, sizeof(seq));
+    return write(fd, &frame, sizeof(frame)) == sizeof(frame);
+  }
+
+  int fd = -1;
+};
+
+uint32_t sequence(const CanEvent* e) {
+  uint32_t seq;
+  std::memcpy(&seq, e->dat, sizeof(seq));
+  return seq;
+}
+
+bool hasDevices(const QStringList& wanted) {
+  const QStringList devices = SocketCanStream::availableDevices();
+  return std::ranges::all_of(wanted, [&](auto& d) { return devices.contains(d); });
+}
+
+}  // namespace
+
+void TestSocketCanStream::initTestCase() {
+  settings.log_livestream = false;
+  if (!SocketCanStream::available()) QSKIP("SocketCAN is not available");
+}
+
+void TestSocketCanStream::keepsKernelTimestamps() {
+  if (!hasDevices({"vcan0"})) QSKIP("Needs vcan0 (ip link add dev vcan0 type vcan && ip link set vcan0 up)");
+
+  // Frames queue in the stream's socket until it starts and are then read in one go. Their times
+  // must still be when the kernel received each of them, spread out by the pauses between writes.
+  SocketCanStream stream(qApp, {QStringList{"vcan0"}});
+  CanSender sender("vcan0");
+  QVERIFY(sender.fd >= 0);
+
+  constexpr uint32_t kFrames = 20;
+  constexpr uint64_t kClockSlackNs = 1'000'000;  // Converting the kernel's realtime stamps to the boot clock
+  const uint32_t addresses[] = {0x123, 0x1abcdef | CAN_EFF_FLAG};
+  std::vector<std::pair<uint64_t, uint64_t>> sent;  // Boot clock around each write
+  for (uint32_t seq = 0; seq < kFrames; ++seq) {
+    const uint64_t before = nanos_since_boot();
+    QVERIFY(sender.send(addresses[seq % 2], seq));
+    sent.push_back({before, nanos_since_boot()});
+    QThread::msleep(5);
+  }
+
+  stream.start();
+  QVERIFY(QTest::qWaitFor([&]() { return stream.allEvents().size() >= kFrames; }, 10'000));
+  stream.stop();
+
+  const auto& events = stream.allEvents();
+  QCOMPARE(events.size(), size_t(kFrames));
+  for (uint32_t i = 0; i < kFrames; ++i) {
+    const CanEvent* e = events[i];
+    QCOMPARE(sequence(e), i);
+    QCOMPARE(e->src, uint8_t(0));
+    QCOMPARE(e->address, addresses[i % 2] & CAN_EFF_MASK);
+    QVERIFY(e->mono_ns + kClockSlackNs >= sent[i].first);
+    QVERIFY(e->mono_ns <= sent[i].second + kClockSlackNs);
+  }
+  QCOMPARE(stream.interfaceStats().front().frames, uint64_t(kFrames));
+}
+
+void TestSocketCanStream::mergesInterfaces() {
+  if (!hasDevices(kDevices)) QSKIP("Needs vcan0 and vcan1 (ip link add dev vcanN type vcan && ip link set vcanN up)");
+
+  SocketCanStream stream(qApp, {kDevices});
+  stream.start();
+
+  // Interleave the devices so frames from both are pending in the same reorder window.
+  // The kernel stamps each frame as it is written, so send order is timestamp order.
+  CanSender senders[] = {CanSender(kDevices[0]), CanSender(kDevices[1])};
+  QVERIFY(senders[0].fd >= 0 && senders[1].fd >= 0);
+  for (uint32_t seq = 0; seq < 2 * kFramesPerDevice; ++seq) {
+    const int bus = seq % 2;
+    QVERIFY(senders[bus].send(0x100 + bus, seq));
+  }
+
+  const size_t total = 2 * kFramesPerDevice;
+  QVERIFY(QTest::qWaitFor([&]() { return stream.allEvents().size() >= total; }, 10'000));
+  stream.stop();
+
+  // Each interface is its own bus, in config order
+  const auto& events = stream.allEvents();
+  QCOMPARE(events.size(), total);
+  for (const CanEvent* e : events) {
+    QCOMPARE(e->src, static_cast<uint8_t>(e->address - 0x100));
+    QCOMPARE(e->size, static_cast<uint8_t>(sizeof(uint32_t)));
+  }
+
+  // Merged in timestamp order; frames only swap places when the kernel gave them the same timestamp
+  QVERIFY(std::ranges::is_sorted(events, {}, &CanEvent::mono_ns));
+  for (size_t i = 1; i < events.size(); ++i) {
+    if (events[i - 1]->mono_ns < events[i]->mono_ns) QVERIFY(sequence(events[i - 1]) < sequence(events[i]));
+  }
+
+  // Every frame written is counted against its interface and none overflowed the receive queue
+  const auto stats = stream.interfaceStats();
+  QCOMPARE(stats.size(), size_t(2));
+  for (uint8_t bus = 0; bus < 2; ++bus) {
+    QCOMPARE(stats[bus].device, kDevices[bus]);
+    QCOMPARE(stats[bus].bus, bus);
+    QCOMPARE(stats[bus].frames, uint64_t(kFramesPerDevice));
+    QCOMPARE(stats[bus].dropped, uint32_t(0));
+  }
+}
+
+#else
+
+void TestSocketCanStream::initTestCase() { QSKIP("SocketCAN is only available on Linux"); }
+void TestSocketCanStream::keepsKernelTimestamps() {}
+void TestSocketCanStream::mergesInterfaces() {}
+
+#endif
+
+QTEST_MAIN(TestSocketCanStream)
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <QObject>
+
+class TestSocketCanStream : public QObject {
+  Q_OBJECT
+
+ private slots:
+  void initTestCase();
+  void keepsKernelTimestamps();
+  void mergesInterfaces();
+};
@@ -0,0 +1,91 @@
+#include "tools/memoryusage.h"
+
+#include <QApplication>
+#include <QClipboard>
+#include <QDialogButtonBox>
+#include <QFile>
+#include <QFileDialog>
+#include <QHeaderView>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QTableWidget>
+#include <QTimer>
+#include <QVBoxLayout>
+
+#include "modules/settings/settings.h"
+#include "modules/system/stream_manager.h"
+#include "replay/include/util.h"
+#include "utils/mem_usage.h"
+
+MemoryUsageDlg::MemoryUsageDlg(QWidget* parent) : QDialog(parent) {
+  setWindowTitle(tr("Memory Usage"));
+
+  const int rows = (int)mem::Pool::Count + 1;
+  table = new QTableWidget(rows, 2, this);
+  table->setToolTip(tr("Estimated from container sizes; does not include allocator overhead or video"));
+  table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+  table->setSelectionMode(QAbstractItemView::NoSelection);
+  table->setHorizontalHeaderLabels({tr("Subsystem"), tr("Size")});
+  table->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+  table->horizontalHeader()->setSectionResizeMode(1, QHeaderView::ResizeToContents);
+  table->verticalHeader()->setVisible(false);
+  for (int i = 0; i < rows; ++i) {
+    table->setItem(i, 0, new QTableWidgetItem(i < (int)mem::Pool::Count ? mem::name((mem::Pool)i) : tr("Total")));
+    auto* size_item = new QTableWidgetItem();
+    size_item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    table->setItem(i, 1, size_item);
+  }
+  QFont bold = table->item(rows - 1, 0)->font();
+  bold.setBold(true);
+  table->item(rows - 1, 0)->setFont(bold);
+  table->item(rows - 1, 1)->setFont(bold);
+  table->setMinimumHeight(table->rowHeight(0) * rows + table->horizontalHeader()->height() + table->frameWidth() * 2);
+
+  auto* buttons = new QDialogButtonBox(QDialogButtonBox::Close, this);
+  auto* copy_btn = buttons->addButton(tr("Copy Report"), QDialogButtonBox::ActionRole);
+  auto* save_btn = buttons->addButton(tr("Save Report..."), QDialogButtonBox::ActionRole);
+
+  QVBoxLayout* layout = new QVBoxLayout(this);
+  layout->addWidget(table);
+  layout->addWidget(buttons);
+
+  connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+  connect(copy_btn, &QPushButton::clicked, [this]() { QApplication::clipboard()->setText(report()); });
+  connect(save_btn, &QPushButton::clicked, this, &MemoryUsageDlg::saveReport);
+
+  // The counters are kept up to date by their owners, refreshing only reads them
+  auto* timer = new QTimer(this);
+  connect(timer, &QTimer::timeout, this, &MemoryUsageDlg::refresh);
+  timer->start(1000);
+  refresh();
+}
+
+void MemoryUsageDlg::refresh() {
+  int64_t total = 0;
+  for (int i = 0; i < (int)mem::Pool::Count; ++i) {
+    const int64_t bytes = mem::bytes((mem::Pool)i);
+    total += bytes;
+    table->item(i, 1)->setText(QString::fromStdString(formattedDataSize(bytes)));
+  }
+  table->item((int)mem::Pool::Count, 1)->setText(QString::fromStdString(formattedDataSize(total)));
+}
+
+QString MemoryUsageDlg::report() const {
+  auto* stream = StreamManager::stream();
+  QString header = QString("%1\nStream: %2\nEvents: %3 over %4 s\n\n")
+                       .arg(qApp->applicationDisplayName(), stream->routeName())
+                       .arg(stream->allEvents().size())
+                       .arg(stream->maxSeconds() - stream->minSeconds(), 0, 'f', 1);
+  return header + mem::report();
+}
+
+void MemoryUsageDlg::saveReport() {
+  QString fn = QFileDialog::getSaveFileName(this, tr("Save Memory Report"), settings.last_dir + "/cabana-memory.txt",
+                                            tr("Text (*.txt)"));
+  if (fn.isEmpty()) return;
+
+  QFile file(fn);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Text) || file.write(report().toUtf8()) < 0) {
+    QMessageBox::warning(this, tr("Save Memory Report"), tr("Failed to write %1").arg(fn));
+  }
+}
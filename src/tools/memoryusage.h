@@ -0,0 +1,19 @@
+#pragma once
+
+#include <QDialog>
+
+class QTableWidget;
+
+class MemoryUsageDlg : public QDialog {
+  Q_OBJECT
+
+ public:
+  MemoryUsageDlg(QWidget* parent = nullptr);
+
+ private:
+  QString report() const;
+  void refresh();
+  void saveReport();
+
+  QTableWidget* table;
+};
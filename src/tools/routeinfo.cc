@@ -1,6 +1,7 @@
 #include "tools/routeinfo.h"
 
 #include <QHeaderView>
+#include <QLabel>
 #include <QScrollBar>
 #include <QTableWidget>
 #include <QVBoxLayout>
@@ -9,7 +10,8 @@
 #include "modules/system/stream_manager.h"
 
 RouteInfoDlg::RouteInfoDlg(QWidget* parent) : QDialog(parent) {
-  auto* replay = qobject_cast<ReplayStream*>(StreamManager::stream())->getReplay();
+  auto* stream = qobject_cast<ReplayStream*>(StreamManager::stream());
+  auto* replay = stream->getReplay();
   setWindowTitle(tr("Route: %1").arg(QString::fromStdString(replay->route().name())));
 
   auto* table = new QTableWidget(replay->route().segments().size(), 7, this);
@@ -42,4 +44,19 @@ RouteInfoDlg::RouteInfoDlg(QWidget* parent) : QDialog(parent) {
 
   QVBoxLayout* layout = new QVBoxLayout(this);
   layout->addWidget(table);
+
+  if (auto* prefetcher = stream->prefetcher()) {
+    const auto stats = prefetcher->stats();
+    const uint64_t entered = stats.hits + stats.misses;
+    auto* prefetch_label = new QLabel(this);
+    prefetch_label->setText(tr("Prefetch: %1 of %2 segments ready in time (%3%), %4 downloaded, %5 failed")
+                                .arg(stats.hits)
+                                .arg(entered)
+                                .arg(entered ? stats.hits * 100 / entered : 0)
+                                .arg(stats.fetched)
+                                .arg(stats.failed));
+    prefetch_label->setToolTip(tr("Segments are downloaded ahead of playback, scaled by playback speed,\n"
+                                  "and when hovering a position on the timeline."));
+    layout->addWidget(prefetch_label);
+  }
 }
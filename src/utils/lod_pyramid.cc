@@ -0,0 +1,105 @@
+#include "utils/lod_pyramid.h"
+
+#include <algorithm>
+#include <cmath>
+
+void LodPyramid::append(const std::vector<QPointF>& pts) {
+  for (size_t i = count_; i < pts.size(); ++i) {
+    const uint32_t idx = i;
+    const double y = pts[i].y();
+    for (size_t lvl = 0; lvl < levels_.size(); ++lvl) {
+      auto& level = levels_[lvl];
+      const size_t b = i >> (kBaseShift + lvl);
+      if (b == level.size()) {
+        level.push_back({idx, idx, idx, idx});
+      } else {
+        Bucket& bucket = level[b];
+        bucket.last = idx;
+        if (y < pts[bucket.min].y()) bucket.min = idx;
+        if (y > pts[bucket.max].y()) bucket.max = idx;
+      }
+    }
+    count_ = i + 1;
+    // A level is only worth keeping once the level below it has more than one bucket
+    if (levels_.empty() || levels_.back().size() > 1) addLevel(pts);
+  }
+}
+
+void LodPyramid::addLevel(const std::vector<QPointF>& pts) {
+  std::vector<Bucket> level;
+  if (levels_.empty()) {
+    for (size_t i = 0; i < count_; ++i) {
+      const uint32_t idx = i;
+      if ((i & ((1 << kBaseShift) - 1)) == 0) {
+        level.push_back({idx, idx, idx, idx});
+      } else {
+        level.back() = merge(level.back(), {idx, idx, idx, idx}, pts);
+      }
+    }
+  } else {
+    const auto& below = levels_.back();
+    level.reserve((below.size() + 1) / 2);
+    for (size_t i = 0; i < below.size(); i += 2) {
+      level.push_back(i + 1 < below.size() ? merge(below[i], below[i + 1], pts) : below[i]);
+    }
+  }
+  levels_.push_back(std::move(level));
+}
+
+LodPyramid::Bucket LodPyramid::merge(const Bucket& a, const Bucket& b, const std::vector<QPointF>& pts) {
+  return {a.first, b.last, pts[b.min].y() < pts[a.min].y() ? b.min : a.min,
+          pts[b.max].y() > pts[a.max].y() ? b.max : a.max};
+}
+
+void LodPyramid::clear() {
+  levels_.clear();
+  count_ = 0;
+}
+
+std::pair<size_t, size_t> LodPyramid::visibleRange(const std::vector<QPointF>& pts, size_t n, double min_x,
+                                                   double max_x) {
+  auto first = std::lower_bound(pts.begin(), pts.begin() + n, min_x, [](auto& p, double x) { return p.x() < x; });
+  auto last = std::upper_bound(first, pts.begin() + n, max_x, [](double x, auto& p) { return x < p.x(); });
+  const size_t begin = std::distance(pts.begin(), first) - (first != pts.begin());
+  const size_t end = std::min<size_t>(std::distance(pts.begin(), last) + 1, n);
+  return {begin, std::max(begin, end)};
+}
+
+void LodPyramid::visiblePoints(const std::vector<QPointF>& pts, double min_x, double max_x, int width,
+                               QList<QPointF>& out) const {
+  out.clear();
+  const auto [begin, end] = visibleRange(pts, std::min(pts.size(), count_), min_x, max_x);
+  if (begin == end) return;
+
+  if (!isDecimated(end - begin, width) || levels_.empty()) {
+    out.assign(pts.begin() + begin, pts.begin() + end);
+    return;
+  }
+
+  // Coarsest level whose buckets still fit in one pixel column
+  const double per_px = double(end - begin) / std::max(width, 1);
+  const int lvl = std::clamp((int)std::floor(std::log2(per_px)) - kBaseShift, 0, (int)levels_.size() - 1);
+  const int shift = kBaseShift + lvl;
+  const auto& level = levels_[lvl];
+  out.reserve(4 * ((end - begin) >> shift) + (2 << shift));
+
+  // Partly covered buckets at either end are emitted raw so nothing outside the range leaks in
+  size_t i = begin;
+  const size_t head_end = std::min(((begin + (1 << shift) - 1) >> shift) << shift, end);
+  for (; i < head_end; ++i) out.push_back(pts[i]);
+  for (; i + (1 << shift) <= end; i += (1 << shift)) {
+    const Bucket& b = level[i >> shift];
+    uint32_t idx[] = {b.first, b.min, b.max, b.last};
+    std::sort(std::begin(idx), std::end(idx));
+    for (int k = 0; k < 4; ++k) {
+      if (k == 0 || idx[k] != idx[k - 1]) out.push_back(pts[idx[k]]);
+    }
+  }
+  for (; i < end; ++i) out.push_back(pts[i]);
+}
+
+size_t LodPyramid::memoryUsage() const {
+  size_t bytes = levels_.capacity() * sizeof(levels_[0]);
+  for (const auto& level : levels_) bytes += level.capacity() * sizeof(Bucket);
+  return bytes;
+}
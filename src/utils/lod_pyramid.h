@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QList>
+#include <QPointF>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Level-of-detail pyramid over a time-ordered series. Each level splits the series into buckets
+// of 2^(kBaseShift + level) points and keeps the first, last, min and max point of each (M4).
+// A plot then receives at most a few points per pixel column, so zooming and panning cost is
+// proportional to the plot width rather than the number of samples. Grows in place as points
+// are appended; anything else needs a clear().
+class LodPyramid {
+ public:
+  // Catches up with points appended to `pts` since the last call
+  void append(const std::vector<QPointF>& pts);
+  void clear();
+  // The points needed to draw [min_x, max_x] over `width` pixels: the raw points if there are
+  // few enough, otherwise the M4 points of each bucket. Includes one point past each end so
+  // lines run to the plot edges.
+  void visiblePoints(const std::vector<QPointF>& pts, double min_x, double max_x, int width, QList<QPointF>& out) const;
+  size_t memoryUsage() const;
+
+  // Index range [begin, end) of the first `n` points that visiblePoints() draws from
+  static std::pair<size_t, size_t> visibleRange(const std::vector<QPointF>& pts, size_t n, double min_x,
+                                                double max_x);
+  // Whether `n` points over `width` pixels are reduced to M4 points rather than passed through
+  static bool isDecimated(size_t n, int width) { return n > (size_t)std::max(width, 1) * kPointsPerPixel; }
+
+ private:
+  struct Bucket {
+    uint32_t first, last, min, max;  // Indices into the series
+  };
+
+  static constexpr int kBaseShift = 3;      // Level 0 buckets hold 8 points
+  static constexpr int kPointsPerPixel = 4;  // Raw points are used up to this density
+
+  void addLevel(const std::vector<QPointF>& pts);
+  static Bucket merge(const Bucket& a, const Bucket& b, const std::vector<QPointF>& pts);
+
+  std::vector<std::vector<Bucket>> levels_;
+  size_t count_ = 0;
+};
@@ -0,0 +1,44 @@
+#include "utils/mem_usage.h"
+
+#include <QTextStream>
+
+#include "replay/include/util.h"
+
+namespace mem {
+
+namespace detail {
+std::array<std::atomic<int64_t>, (size_t)Pool::Count> pools = {};
+}  // namespace detail
+
+const char* name(Pool p) {
+  switch (p) {
+    case Pool::EventArena: return "Event arena";
+    case Pool::EventLists: return "Event lists";
+    case Pool::TimeIndex: return "Time index";
+    case Pool::MessageStates: return "Message states";
+    case Pool::MessageSnapshots: return "Message snapshots";
+    case Pool::ChartValues: return "Chart values";
+    case Pool::ChartMinMax: return "Chart min/max index";
+    case Pool::ChartLod: return "Chart LOD pyramids";
+    case Pool::ChartSeries: return "Chart series";
+    case Pool::Sparklines: return "Sparklines";
+    case Pool::History: return "History log";
+    default: return "";
+  }
+}
+
+QString report() {
+  QString text;
+  QTextStream out(&text);
+  int64_t total = 0;
+  for (int i = 0; i < (int)Pool::Count; ++i) {
+    const int64_t n = bytes((Pool)i);
+    total += n;
+    out << QString("%1 %2\n").arg(name((Pool)i), -20).arg(QString::fromStdString(formattedDataSize(n)), 12);
+  }
+  out << QString("%1 %2\n").arg("Total", -20).arg(QString::fromStdString(formattedDataSize(total)), 12);
+  out.flush();
+  return text;
+}
+
+}  // namespace mem
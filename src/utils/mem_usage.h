@@ -0,0 +1,83 @@
+#pragma once
+
+#include <QString>
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Memory accounting per subsystem. Owners report what they hold whenever their containers
+// change, so reading the totals costs nothing. Sizes are estimates from container sizes and
+// capacities, not allocator statistics.
+namespace mem {
+
+enum class Pool {
+  EventArena,
+  EventLists,
+  TimeIndex,
+  MessageStates,
+  MessageSnapshots,
+  ChartValues,
+  ChartMinMax,
+  ChartLod,
+  ChartSeries,
+  Sparklines,
+  History,
+  Count
+};
+
+namespace detail {
+extern std::array<std::atomic<int64_t>, (size_t)Pool::Count> pools;
+}  // namespace detail
+
+inline void add(Pool p, int64_t delta) { detail::pools[(size_t)p].fetch_add(delta, std::memory_order_relaxed); }
+inline int64_t bytes(Pool p) { return detail::pools[(size_t)p].load(std::memory_order_relaxed); }
+const char* name(Pool p);
+// Plain text table of all pools, for bug reports
+QString report();
+
+// Estimated size of a std::unordered_map: each node holds its pair and a next pointer
+template <typename Map>
+size_t hashTableBytes(const Map& m) {
+  return m.size() * (sizeof(typename Map::value_type) + sizeof(void*)) + m.bucket_count() * sizeof(void*);
+}
+
+// What one owner holds in a pool, released when the owner is destroyed
+class Usage {
+ public:
+  explicit Usage(Pool p) : pool_(p) {}
+  Usage(const Usage& other) : pool_(other.pool_) { set(other.bytes_); }
+  Usage(Usage&& other) noexcept : pool_(other.pool_), bytes_(other.bytes_) { other.bytes_ = 0; }
+  Usage& operator=(const Usage& other) {
+    if (this != &other) {
+      set(0);
+      pool_ = other.pool_;
+      set(other.bytes_);
+    }
+    return *this;
+  }
+  Usage& operator=(Usage&& other) noexcept {
+    if (this != &other) {
+      set(0);
+      pool_ = other.pool_;
+      bytes_ = other.bytes_;
+      other.bytes_ = 0;
+    }
+    return *this;
+  }
+  ~Usage() { mem::add(pool_, -bytes_); }
+
+  void set(size_t n) {
+    mem::add(pool_, (int64_t)n - bytes_);
+    bytes_ = n;
+  }
+  void add(int64_t delta) {
+    mem::add(pool_, delta);
+    bytes_ += delta;
+  }
+
+ private:
+  Pool pool_;
+  int64_t bytes_ = 0;
+};
+
+}  // namespace mem
@@ -0,0 +1,101 @@
+#include "utils/perf.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace perf {
+
+namespace {
+
+// Each metric on its own cache line, so the stream thread and the GUI thread don't contend
+struct alignas(64) AtomicCounter {
+  std::atomic<uint64_t> value{0};
+};
+
+struct alignas(64) AtomicGauge {
+  std::atomic<int64_t> value{0};
+};
+
+struct alignas(64) AtomicHistogram {
+  std::array<std::atomic<uint64_t>, kBuckets> buckets = {};
+  std::atomic<uint64_t> count{0};
+  std::atomic<uint64_t> total_ns{0};
+};
+
+AtomicCounter counters[(size_t)Counter::Count];
+AtomicGauge gauges[(size_t)Gauge::Count];
+AtomicHistogram timings[(size_t)Timing::Count];
+
+int bucketOf(uint64_t ns) {
+  const uint64_t us = ns / 1000;
+  return std::min<int>(std::bit_width(us), kBuckets - 1);
+}
+
+}  // namespace
+
+namespace detail {
+
+std::atomic<bool> enabled{false};
+
+void add(Counter c, uint64_t n) { counters[(size_t)c].value.fetch_add(n, std::memory_order_relaxed); }
+
+void set(Gauge g, int64_t value) { gauges[(size_t)g].value.store(value, std::memory_order_relaxed); }
+
+void record(Timing t, uint64_t ns) {
+  auto& h = timings[(size_t)t];
+  h.buckets[bucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+  h.count.fetch_add(1, std::memory_order_relaxed);
+  h.total_ns.fetch_add(ns, std::memory_order_relaxed);
+}
+
+}  // namespace detail
+
+void setEnabled(bool on) { detail::enabled.store(on, std::memory_order_relaxed); }
+
+Snapshot snapshot() {
+  Snapshot s;
+  for (size_t i = 0; i < s.counters.size(); ++i) {
+    s.counters[i] = counters[i].value.load(std::memory_order_relaxed);
+  }
+  for (size_t i = 0; i < s.gauges.size(); ++i) {
+    s.gauges[i] = gauges[i].value.load(std::memory_order_relaxed);
+  }
+  for (size_t i = 0; i < s.timings.size(); ++i) {
+    for (int b = 0; b < kBuckets; ++b) {
+      s.timings[i].buckets[b] = timings[i].buckets[b].load(std::memory_order_relaxed);
+    }
+    s.timings[i].count = timings[i].count.load(std::memory_order_relaxed);
+    s.timings[i].total_ns = timings[i].total_ns.load(std::memory_order_relaxed);
+  }
+  return s;
+}
+
+const char* name(Counter c) {
+  switch (c) {
+    case Counter::FramesIngested: return "Frames ingested";
+    default: return "";
+  }
+}
+
+const char* name(Gauge g) {
+  switch (g) {
+    case Gauge::QueueDepth: return "Queue depth";
+    default: return "";
+  }
+}
+
+const char* name(Timing t) {
+  switch (t) {
+    case Timing::SnapshotCommit: return "Snapshot commit";
+    case Timing::EventsMerged: return "eventsMerged fan-out";
+    case Timing::ChartPrepare: return "Chart prepare";
+    case Timing::ChartReplace: return "Chart replace";
+    case Timing::ChartPaint: return "Chart paint";
+    case Timing::EventLoopLag: return "Event loop lag";
+    default: return "";
+  }
+}
+
+uint64_t bucketLimitNs(int bucket) { return (1ULL << bucket) * 1000; }
+
+}  // namespace perf
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "common/timing.h"
+
+// Hot-path instrumentation of the ingest -> commit -> paint pipeline. Recording costs a few
+// relaxed atomic operations and is skipped entirely while disabled, so probes can stay in the
+// code permanently. Any thread may record; the performance panel reads the totals.
+namespace perf {
+
+enum class Counter { FramesIngested, Count };
+enum class Gauge { QueueDepth, Count };
+enum class Timing { SnapshotCommit, EventsMerged, ChartPrepare, ChartReplace, ChartPaint, EventLoopLag, Count };
+
+// Bucket 0 holds durations under 1us, bucket i durations in [2^(i-1), 2^i) us, the last one the rest
+constexpr int kBuckets = 24;
+
+struct Histogram {
+  std::array<uint64_t, kBuckets> buckets = {};
+  uint64_t count = 0;
+  uint64_t total_ns = 0;
+};
+
+// Running totals since startup. The panel diffs consecutive snapshots for rates and windows.
+struct Snapshot {
+  std::array<uint64_t, (size_t)Counter::Count> counters = {};
+  std::array<int64_t, (size_t)Gauge::Count> gauges = {};
+  std::array<Histogram, (size_t)Timing::Count> timings = {};
+};
+
+namespace detail {
+extern std::atomic<bool> enabled;
+void add(Counter c, uint64_t n);
+void set(Gauge g, int64_t value);
+void record(Timing t, uint64_t ns);
+}  // namespace detail
+
+inline bool enabled() { return detail::enabled.load(std::memory_order_relaxed); }
+void setEnabled(bool on);
+
+inline void add(Counter c, uint64_t n = 1) {
+  if (enabled()) detail::add(c, n);
+}
+inline void set(Gauge g, int64_t value) {
+  if (enabled()) detail::set(g, value);
+}
+inline void record(Timing t, uint64_t ns) {
+  if (enabled()) detail::record(t, ns);
+}
+
+Snapshot snapshot();
+const char* name(Counter c);
+const char* name(Gauge g);
+const char* name(Timing t);
+// Upper bound of a histogram bucket in nanoseconds
+uint64_t bucketLimitNs(int bucket);
+
+// Records the time until the end of the scope
+class ScopedTimer {
+ public:
+  explicit ScopedTimer(Timing t) : timing_(t), start_ns_(enabled() ? nanos_since_boot() : 0) {}
+  ~ScopedTimer() {
+    if (start_ns_) detail::record(timing_, nanos_since_boot() - start_ns_);
+  }
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+ private:
+  const Timing timing_;
+  const uint64_t start_ns_;
+};
+
+}  // namespace perf
@@ -0,0 +1,44 @@
+#include "utils/range_minmax.h"
+
+void RangeMinMax::addBlock(const MinMax& block) {
+  if (levels_.empty()) levels_.emplace_back();
+  levels_[0].push_back(block);
+
+  // The new block completes one more span on each level: the one ending at it
+  const size_t count = levels_[0].size();
+  for (size_t k = 1; (size_t(1) << k) <= count; ++k) {
+    if (k == levels_.size()) levels_.emplace_back();
+    const auto& below = levels_[k - 1];
+    MinMax span = below[count - (size_t(1) << k)];
+    span.combine(below[count - (size_t(1) << (k - 1))]);
+    levels_[k].push_back(span);
+  }
+}
+
+MinMax RangeMinMax::blocks(size_t first, size_t last) const {
+  const int k = std::bit_width(last - first + 1) - 1;
+  MinMax result = levels_[k][first];
+  result.combine(levels_[k][last + 1 - (size_t(1) << k)]);
+  return result;
+}
+
+void RangeMinMax::invalidateFrom(size_t index) {
+  const size_t block = (index + dropped_) / kBlockSize;
+  for (size_t k = 0; k < levels_.size(); ++k) {
+    const size_t span = size_t(1) << k;
+    const size_t keep = block >= span ? block - span + 1 : 0;
+    if (levels_[k].size() > keep) levels_[k].resize(keep);
+  }
+  while (!levels_.empty() && levels_.back().empty()) levels_.pop_back();
+}
+
+void RangeMinMax::clear() {
+  levels_.clear();
+  dropped_ = 0;
+}
+
+size_t RangeMinMax::memoryUsage() const {
+  size_t bytes = levels_.capacity() * sizeof(levels_[0]);
+  for (const auto& level : levels_) bytes += level.capacity() * sizeof(MinMax);
+  return bytes;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <QPointF>
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+struct MinMax {
+  double min = std::numeric_limits<double>::max();
+  double max = std::numeric_limits<double>::lowest();
+
+  inline void combine(double val) {
+    if (val < min) min = val;
+    if (val > max) max = val;
+  }
+
+  inline void combine(const MinMax& other) {
+    if (other.min < min) min = other.min;
+    if (other.max > max) max = other.max;
+  }
+};
+
+// The value of a series element that RangeMinMax indexes. Other element types provide their own
+// overload, found by argument-dependent lookup.
+inline double minMaxValue(const QPointF& pt) { return pt.y(); }
+
+/**
+ * @brief RangeMinMax answers min/max over any index range of a series.
+ * The series is split into blocks of kBlockSize values. A sparse table over the block extremes
+ * covers whole blocks with two lookups, and the partial blocks at both ends are scanned. Once
+ * append() has seen the whole series, a query reads at most 2 * kBlockSize values however long
+ * the range is. The index keeps no copy of the values; the series is passed to every call.
+ * Appends extend the table in place, and an insertion only rebuilds the blocks after it.
+ */
+class RangeMinMax {
+ public:
+  static constexpr size_t kBlockSize = 128;
+
+  // Indexes the values appended to `series` since the last call
+  template <typename Series>
+  void append(const Series& series);
+  // Values from `index` on were inserted or changed, the next append() reads them again
+  void invalidateFrom(size_t index);
+  // The series dropped its first `n` values, later indices are relative to its new front
+  void dropFront(size_t n) { dropped_ += n; }
+  // Min/max of series[l..r], both inclusive
+  template <typename Series>
+  MinMax query(const Series& series, size_t l, size_t r) const;
+  void clear();
+  size_t memoryUsage() const;
+
+ private:
+  void addBlock(const MinMax& block);
+  MinMax blocks(size_t first, size_t last) const;
+
+  // levels_[k][j] holds the extremes of blocks [j, j + 2^k)
+  std::vector<std::vector<MinMax>> levels_;
+  size_t dropped_ = 0;  // Values dropped from the front, block boundaries stay where they were
+};
+
+template <typename Series>
+void RangeMinMax::append(const Series& series) {
+  // Start over once more has been dropped than is left, so the table doesn't grow without bound
+  if (dropped_ > kBlockSize && dropped_ > (size_t)series.size()) clear();
+
+  const size_t full_blocks = (dropped_ + series.size()) / kBlockSize;
+  for (size_t b = levels_.empty() ? 0 : levels_[0].size(); b < full_blocks; ++b) {
+    MinMax block;
+    for (size_t i = std::max(b * kBlockSize, dropped_); i < (b + 1) * kBlockSize; ++i) {
+      block.combine(minMaxValue(series[i - dropped_]));
+    }
+    addBlock(block);
+  }
+}
+
+template <typename Series>
+MinMax RangeMinMax::query(const Series& series, size_t l, size_t r) const {
+  MinMax result;
+  if (l > r || r >= (size_t)series.size()) return result;
+
+  auto scan = [&](size_t first, size_t last) {
+    for (size_t i = first; i <= last; ++i) result.combine(minMaxValue(series[i]));
+  };
+  const size_t first_block = (l + dropped_) / kBlockSize;
+  const size_t last_block = (r + dropped_) / kBlockSize;
+  const size_t full_blocks = levels_.empty() ? 0 : levels_[0].size();
+  if (last_block <= first_block + 1 || last_block > full_blocks) {
+    scan(l, r);
+  } else {
+    scan(l, (first_block + 1) * kBlockSize - dropped_ - 1);
+    result.combine(blocks(first_block + 1, last_block - 1));
+    scan(last_block * kBlockSize - dropped_, r);
+  }
+  return result;
+}
@@ -48,6 +48,7 @@ class TimeIndex {
   }
 
   void clear() { indices_.clear(); }
+  size_t memoryUsage() const { return indices_.capacity() * sizeof(size_t); }
 
  private:
   std::vector<size_t> indices_;
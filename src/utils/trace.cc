@@ -0,0 +1,145 @@
+#include "utils/trace.h"
+
+#include <QDebug>
+#include <QFile>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace trace {
+
+namespace {
+
+constexpr size_t kMaxSlicesPerThread = 1 << 20;  // About 24MB per thread
+constexpr qint64 kWriteChunk = 1 << 20;
+
+struct Slice {
+  const char* name;
+  uint64_t start_ns;
+  uint64_t end_ns;
+};
+
+struct ThreadBuffer {
+  int tid = 0;
+  std::string name;
+  std::mutex lock;  // Only contended while a trace is being started or written
+  std::vector<Slice> slices;
+  uint64_t dropped = 0;
+};
+
+// Buffers outlive their threads, so slices of finished pool threads are still exported
+std::mutex registry_lock;
+std::vector<std::shared_ptr<ThreadBuffer>> registry;
+
+ThreadBuffer& localBuffer() {
+  thread_local std::shared_ptr<ThreadBuffer> buffer = []() {
+    auto b = std::make_shared<ThreadBuffer>();
+    std::lock_guard lk(registry_lock);
+    b->tid = registry.size() + 1;
+    b->name = "Thread " + std::to_string(b->tid);
+    registry.push_back(b);
+    return b;
+  }();
+  return *buffer;
+}
+
+void clearBuffers() {
+  std::lock_guard lk(registry_lock);
+  for (auto& b : registry) {
+    std::lock_guard buffer_lk(b->lock);
+    b->slices = {};
+    b->dropped = 0;
+  }
+}
+
+QByteArray quoted(const std::string& s) {
+  QByteArray out = "\"";
+  for (char c : s) {
+    if (c == '"' || c == '\\') out += '\\';
+    out += c;
+  }
+  return out + "\"";
+}
+
+}  // namespace
+
+namespace detail {
+
+std::atomic<bool> recording{false};
+
+void record(const char* name, uint64_t start_ns, uint64_t end_ns) {
+  ThreadBuffer& b = localBuffer();
+  std::lock_guard lk(b.lock);
+  if (b.slices.size() < kMaxSlicesPerThread) {
+    b.slices.push_back({name, start_ns, end_ns});
+  } else {
+    ++b.dropped;
+  }
+}
+
+}  // namespace detail
+
+void setThreadName(const char* name) {
+  ThreadBuffer& b = localBuffer();
+  std::lock_guard lk(b.lock);
+  b.name = name;
+}
+
+void start() {
+  clearBuffers();
+  detail::recording = true;
+}
+
+bool stop(const QString& path) {
+  detail::recording = false;
+  if (path.isEmpty()) {
+    clearBuffers();
+    return true;
+  }
+
+  QFile file(path);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    qWarning() << "trace: failed to open" << path;
+    return false;
+  }
+
+  size_t count = 0;
+  uint64_t dropped = 0;
+  QByteArray out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  std::lock_guard lk(registry_lock);
+  for (auto& b : registry) {
+    std::lock_guard buffer_lk(b->lock);
+    if (b->slices.empty()) continue;
+
+    if (count > 0) out += ",\n";
+    out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + QByteArray::number(b->tid) +
+           ",\"args\":{\"name\":" + quoted(b->name) + "}}";
+    for (const Slice& s : b->slices) {
+      out += ",\n{\"name\":" + quoted(s.name) + ",\"ph\":\"X\",\"pid\":1,\"tid\":" + QByteArray::number(b->tid) +
+             ",\"ts\":" + QByteArray::number(s.start_ns / 1e3, 'f', 3) +
+             ",\"dur\":" + QByteArray::number((s.end_ns - s.start_ns) / 1e3, 'f', 3) + "}";
+      if (out.size() >= kWriteChunk) {
+        file.write(out);
+        out.clear();
+      }
+    }
+    count += b->slices.size();
+    dropped += b->dropped;
+    b->slices = {};  // Free the memory, traces can be large
+  }
+  out += "\n]}\n";
+  file.write(out);
+
+  if (file.error() != QFileDevice::NoError) {
+    qWarning() << "trace: failed to write" << path << file.errorString();
+    return false;
+  }
+  qInfo() << "trace: wrote" << count << "slices to" << path;
+  if (dropped > 0) {
+    qWarning() << "trace:" << dropped << "slices dropped, buffers were full";
+  }
+  return true;
+}
+
+}  // namespace trace
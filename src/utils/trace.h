@@ -0,0 +1,48 @@
+#pragma once
+
+#include <QString>
+#include <atomic>
+#include <cstdint>
+
+#include "common/timing.h"
+
+// Session tracing of the pipeline stages, exported as Chrome trace JSON for chrome://tracing
+// or ui.perfetto.dev. Each thread records into its own buffer; while tracing is off a scope
+// costs one relaxed load.
+//
+//   TRACE_SCOPE("mergeEvents");  // name must be a string literal
+namespace trace {
+
+namespace detail {
+extern std::atomic<bool> recording;
+void record(const char* name, uint64_t start_ns, uint64_t end_ns);
+}  // namespace detail
+
+inline bool isRecording() { return detail::recording.load(std::memory_order_relaxed); }
+// Discards anything recorded before and starts recording
+void start();
+// Stops recording and writes the trace, or discards it if `path` is empty.
+// Returns false if the file could not be written.
+bool stop(const QString& path);
+// Name shown for the calling thread's track
+void setThreadName(const char* name);
+
+class Scope {
+ public:
+  explicit Scope(const char* name) : name_(name), start_ns_(isRecording() ? nanos_since_boot() : 0) {}
+  ~Scope() {
+    if (start_ns_) detail::record(name_, start_ns_, nanos_since_boot());
+  }
+  Scope(const Scope&) = delete;
+  Scope& operator=(const Scope&) = delete;
+
+ private:
+  const char* name_;
+  const uint64_t start_ns_;
+};
+
+}  // namespace trace
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(name) trace::Scope TRACE_CONCAT(trace_scope_, __LINE__)(name)